@@ -0,0 +1,227 @@
+/*******************************************************************************************
+*   MPhysacBench.cpp
+*
+*   Microbenchmarks of MPhysacWorld::PhysicsStep on fixed scenes.
+*   Usage : mphysac_bench [--steps=<count>] [--json=<file>]
+*   Each scene is built, warmed up, then stepped <count> times (600 by default). The JSON output
+*   is meant to be kept between builds so that the regressions of the physics step show up.
+*
+********************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "MPhysac/MPhysacWorld.hpp"
+
+//----------------------------------------------------------------------------------
+// Allocations counter : every heap allocation of the process goes through these
+//----------------------------------------------------------------------------------
+static std::atomic<unsigned long long> allocationsCount(0);
+
+void* operator new(size_t size) {
+    allocationsCount++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+    const std::chrono::duration<float> StepDuration(1.f / 60.f);
+    const unsigned int WarmUpSteps = 30;
+    // Much thicker than what a body moves in a step, so that the contacts push the bodies back in rather than through
+    const float WallThickness = 100.f;
+
+    struct Scene {
+        const char *name;
+        void (*build)(MPhysacWorld &world);
+    };
+
+    struct Result {
+        const char *name;
+        size_t bodies;
+        unsigned int steps;
+        double nsPerStep;
+        double minNsPerStep;
+        double pairsPerStep;
+        double manifoldsPerStep;
+        double allocationsPerStep;
+    };
+
+    MPhysacBody* createWall(MPhysacWorld &world, const Vector2f &pos, float width, float height) {
+        MPhysacBody *wall = world.CreatePhysicsBodyRectangle(pos, width, height, 10.f);
+        wall->enabled = false;
+        wall->useGravity = false;
+        wall->solidType = MPHYSAC_GROUND;
+        return wall;
+    }
+
+    // Closed box of 800x600 with its walls
+    void createBox(MPhysacWorld &world) {
+        const float t = WallThickness;
+        createWall(world, Vector2f(400.f, 590.f + t * 0.5f), 800.f + 2.f * t, t);
+        createWall(world, Vector2f(400.f, 10.f - t * 0.5f), 800.f + 2.f * t, t);
+        createWall(world, Vector2f(10.f - t * 0.5f, 300.f), t, 600.f);
+        createWall(world, Vector2f(790.f + t * 0.5f, 300.f), t, 600.f);
+    }
+
+    // 256 circles falling in a box, from low enough not to tunnel through the floor
+    void buildCircles(MPhysacWorld &world) {
+        createBox(world);
+
+        for (int i = 0; i < 256; i++)
+            world.CreatePhysicsBodyCircle(Vector2f(40.f + (float)(i % 32) * 23.f, 420.f + (float)(i / 32) * 23.f), 10.f, 1.f);
+    }
+
+    // 15 rows of boxes stacked on the floor
+    void buildPyramid(MPhysacWorld &world) {
+        createWall(world, Vector2f(400.f, 600.f), 800.f, 20.f);
+
+        const int rows = 15;
+        for (int row = 0; row < rows; row++)
+            for (int i = 0; i < rows - row; i++)
+                world.CreatePhysicsBodyRectangle(Vector2f(400.f + ((float)i - (float)(rows - row) * 0.5f) * 21.f, 580.f - (float)row * 21.f), 20.f, 20.f, 1.f);
+    }
+
+    // 512 small projectiles against a wall of 64 tiles, without gravity. 5 pixels per step : faster ones tunnel through the tiles.
+    void buildBulletStorm(MPhysacWorld &world) {
+        for (int i = 0; i < 64; i++)
+            createWall(world, Vector2f(700.f, (float)i * 16.f), 16.f, 16.f);
+
+        for (int i = 0; i < 512; i++) {
+            MPhysacBody *bullet = world.CreatePhysicsBodyCircle(Vector2f(20.f + (float)(i % 16) * 12.f, (float)(i / 16) * 32.f), 3.f, 0.5f);
+            bullet->useGravity = false;
+            bullet->velocity = Vector2f(0.3f, 0.f);
+        }
+    }
+
+    // Room of 512 boxes at rest on the floor, nothing moves : the fixed cost of a populated room
+    void buildSleepingRoom(MPhysacWorld &world) {
+        createWall(world, Vector2f(2048.f, 600.f), 4096.f, 20.f);
+
+        for (int i = 0; i < 512; i++)
+            world.CreatePhysicsBodyRectangle(Vector2f(8.f + (float)i * 8.f, 585.f), 6.f, 10.f, 1.f);
+    }
+
+    const Scene scenes[] = {
+        { "circles_in_box", buildCircles },
+        { "box_pyramid", buildPyramid },
+        { "bullet_storm", buildBulletStorm },
+        { "sleeping_room", buildSleepingRoom },
+    };
+
+    Result run(const Scene &scene, unsigned int steps) {
+        typedef std::chrono::steady_clock Clock;
+
+        MPhysacWorld &world = MPhysacWorld::getInstance();
+        world.ResetPhysics();
+        scene.build(world);
+
+        // Steps exactly once per call
+        for (unsigned int i = 0; i < WarmUpSteps; i++)
+            world.RunPhysicsStep(StepDuration);
+
+        const unsigned long long pairs = world.GetPairsTestedCount();
+        const unsigned long long manifolds = world.GetManifoldsCreatedCount();
+        const unsigned long long allocations = allocationsCount;
+
+        double total = 0., minimum = 1e300;
+        for (unsigned int i = 0; i < steps; i++) {
+            const Clock::time_point start = Clock::now();
+            world.RunPhysicsStep(StepDuration);
+            const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+            total += ns;
+            if (ns < minimum)
+                minimum = ns;
+        }
+
+        Result result;
+        result.name = scene.name;
+        result.bodies = world.GetMPhysacBodiesCount();
+        result.steps = steps;
+        result.nsPerStep = total / steps;
+        result.minNsPerStep = minimum;
+        result.pairsPerStep = (double)(world.GetPairsTestedCount() - pairs) / steps;
+        result.manifoldsPerStep = (double)(world.GetManifoldsCreatedCount() - manifolds) / steps;
+        result.allocationsPerStep = (double)(allocationsCount - allocations) / steps;
+
+        return result;
+    }
+
+    void writeJson(std::ostream &out, const std::vector<Result> &results) {
+        out << "{\n  \"benchmark\": \"mphysac\",\n  \"scenes\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            out << "    { \"name\": \"" << r.name << "\", \"bodies\": " << r.bodies << ", \"steps\": " << r.steps
+                << ", \"ns_per_step\": " << r.nsPerStep << ", \"min_ns_per_step\": " << r.minNsPerStep
+                << ", \"pairs_per_step\": " << r.pairsPerStep << ", \"manifolds_per_step\": " << r.manifoldsPerStep
+                << ", \"allocations_per_step\": " << r.allocationsPerStep << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned int steps = 600;
+    std::string jsonFile;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg(argv[i]);
+
+        if (arg.compare(0, 8, "--steps=") == 0) {
+            std::istringstream in(arg.substr(8));
+            if (!(in >> steps) || steps == 0) {
+                std::cerr << "[Error] mphysac_bench - expected a step count in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 7, "--json=") == 0) {
+            jsonFile = arg.substr(7);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--steps=<count>] [--json=<file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    MPhysacWorld &world = MPhysacWorld::getInstance();
+    world.InitPhysics();
+    world.SetPhysicsTimeStep(StepDuration);
+
+    std::vector<Result> results;
+    for (const Scene &scene : scenes)
+        results.push_back(run(scene, steps));
+
+    std::cout << std::left << std::setw(16) << "scene" << std::right << std::setw(8) << "bodies" << std::setw(14) << "ns/step"
+        << std::setw(14) << "min ns/step" << std::setw(12) << "pairs" << std::setw(12) << "manifolds" << std::setw(10) << "allocs" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Result &r : results) {
+        std::cout << std::left << std::setw(16) << r.name << std::right << std::setw(8) << r.bodies << std::setw(14) << r.nsPerStep
+            << std::setw(14) << r.minNsPerStep << std::setw(12) << r.pairsPerStep << std::setw(12) << r.manifoldsPerStep
+            << std::setw(10) << r.allocationsPerStep << std::endl;
+    }
+
+    if (!jsonFile.empty()) {
+        std::ofstream out(jsonFile);
+        if (!out) {
+            std::cerr << "[Error] mphysac_bench - failed to write " << jsonFile << std::endl;
+            return 1;
+        }
+        writeJson(out, results);
+    }
+
+    world.ResetPhysics();
+    return 0;
+}
@@ -0,0 +1,346 @@
+/*******************************************************************************************
+*   MPhysacGolden.cpp
+*
+*   Golden trajectories of MPhysacWorld : canonical scenes are stepped and the state of their
+*   bodies is compared with the files recorded by a trusted build.
+*   Usage : mphysac_golden [--dir=<directory>] [--record] [--exact] [--tolerance=<value>] [--scene=<name>]
+*   --record refuses to write a scene whose moving bodies left its arena : tunnelling through a wall
+*   is a bug of the scene, not a trajectory to keep.
+*   Without --record, exits with 1 if a scene diverges. The comparison is bit exact with --exact
+*   or when MPhysac is built in deterministic mode (MECHA_DETERMINISTIC), within the tolerance
+*   otherwise : |got - expected| <= tolerance * (1 + |expected|).
+*   The files must be recorded again, and the diff reviewed, when the physics change on purpose.
+*
+********************************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "MPhysac/MPhysacWorld.hpp"
+
+namespace {
+    const std::chrono::duration<float> StepDuration(1.f / 60.f);
+    const unsigned int StepsCount = 240;
+    const unsigned int SamplePeriod = 30;       // Steps between two recorded states
+
+    // Fields of a body state, in the order of the files
+    enum Field { PositionX, PositionY, VelocityX, VelocityY, Orient, AngularVelocity, FieldsCount };
+    const char* const fieldNames[FieldsCount] = { "position.x", "position.y", "velocity.x", "velocity.y", "orient", "angularVelocity" };
+
+    struct BodyState {
+        float values[FieldsCount];
+    };
+
+    struct Sample {
+        unsigned int step;
+        std::vector<BodyState> bodies;
+    };
+
+    // Where the moving bodies must stay, their centers at least
+    struct Arena {
+        float left, top, right, bottom;
+    };
+
+    struct Scene {
+        const char *name;
+        void (*build)(MPhysacWorld &world);
+        Arena arena;
+    };
+
+    // The walls are much thicker than what a body moves in a step, so that the contacts push the bodies back in rather than through
+    const float WallThickness = 100.f;
+
+    MPhysacBody* createWall(MPhysacWorld &world, const Vector2f &pos, float width, float height) {
+        MPhysacBody *wall = world.CreatePhysicsBodyRectangle(pos, width, height, 10.f);
+        wall->enabled = false;
+        wall->useGravity = false;
+        wall->solidType = MPHYSAC_GROUND;
+        return wall;
+    }
+
+    // Closed box, its inside is the arena 10 < x < 390, 10 < y < 290
+    const Arena BoxArena = { 10.f, 10.f, 390.f, 290.f };
+
+    void createBox(MPhysacWorld &world) {
+        const float t = WallThickness;
+        createWall(world, Vector2f(200.f, 290.f + t * 0.5f), 400.f + 2.f * t, t);
+        createWall(world, Vector2f(200.f, 10.f - t * 0.5f), 400.f + 2.f * t, t);
+        createWall(world, Vector2f(10.f - t * 0.5f, 150.f), t, 300.f);
+        createWall(world, Vector2f(390.f + t * 0.5f, 150.f), t, 300.f);
+    }
+
+    // Circles against circles and against the walls, dropped from low enough to stay slower than their radius per step
+    void buildCircles(MPhysacWorld &world) {
+        createBox(world);
+
+        for (int i = 0; i < 48; i++)
+            world.CreatePhysicsBodyCircle(Vector2f(30.f + (float)(i % 12) * 29.f + (float)(i / 12) * 3.f, 200.f + (float)(i / 12) * 25.f), 8.f + (float)(i % 3) * 2.f, 1.f);
+    }
+
+    // Stacked boxes : resting contacts and friction
+    void buildStack(MPhysacWorld &world) {
+        createWall(world, Vector2f(200.f, 290.f + WallThickness * 0.5f), 400.f, WallThickness);
+
+        const int rows = 6;
+        for (int row = 0; row < rows; row++)
+            for (int i = 0; i < rows - row; i++)
+                world.CreatePhysicsBodyRectangle(Vector2f(200.f + ((float)i - (float)(rows - row) * 0.5f) * 21.f, 280.f - (float)row * 21.f), 20.f, 20.f, 1.f);
+    }
+
+    // Polygons of 3 to 8 sides falling on each other : clipping and rotations
+    void buildPolygons(MPhysacWorld &world) {
+        createBox(world);
+
+        for (int i = 0; i < 24; i++)
+            world.CreatePhysicsBodyPolygon(Vector2f(40.f + (float)(i % 8) * 44.f, 190.f + (float)(i / 8) * 32.f), 12.f, 3 + i % 6, 1.f);
+    }
+
+    // Projectiles without gravity against a column of static tiles, in a closed box.
+    // As fast as MPhysac allows without tunnelling : a few pixels per step, under the tile half width.
+    void buildBullets(MPhysacWorld &world) {
+        createBox(world);
+        for (int i = 0; i < 18; i++)
+            createWall(world, Vector2f(300.f, 14.f + (float)i * 16.f), 16.f, 16.f);
+
+        for (int i = 0; i < 32; i++) {
+            MPhysacBody *bullet = world.CreatePhysicsBodyCircle(Vector2f(20.f + (float)(i % 4) * 12.f, 24.f + (float)(i / 4) * 32.f + (float)(i % 4) * 4.f), 3.f, 0.5f);
+            bullet->useGravity = false;
+            bullet->velocity = Vector2f(0.3f, 0.01f * (float)(i % 5 - 2));
+        }
+    }
+
+    const Scene scenes[] = {
+        { "circles", buildCircles, BoxArena },
+        { "stack", buildStack, { -200.f, 0.f, 600.f, 290.f } },
+        { "polygons", buildPolygons, BoxArena },
+        { "bullets", buildBullets, { 10.f, 10.f, 292.f, 290.f } },
+    };
+
+    // Steps the scene, escape describes the first moving body found out of the arena (empty if none)
+    std::vector<Sample> simulate(const Scene &scene, std::string &escape) {
+        MPhysacWorld &world = MPhysacWorld::getInstance();
+        world.ResetPhysics();
+        world.InitPhysics();
+        scene.build(world);
+        escape.clear();
+
+        std::vector<Sample> samples;
+        for (unsigned int step = 1; step <= StepsCount; step++) {
+            // Steps exactly once per call
+            world.RunPhysicsStep(StepDuration);
+            if (step % SamplePeriod)
+                continue;
+
+            Sample sample;
+            sample.step = step;
+            for (size_t i = 0; i < world.GetMPhysacBodiesCount(); i++) {
+                const MPhysacBody *body = world.GetMPhysacBody((int)i);
+
+                const Arena &arena = scene.arena;
+                if (escape.empty() && body->enabled && !(body->position.x >= arena.left && body->position.x <= arena.right &&
+                    body->position.y >= arena.top && body->position.y <= arena.bottom)) {
+                    std::ostringstream out;
+                    out << "body " << i << " is out of the arena at step " << step << " (" << body->position.x << ", " << body->position.y << ")";
+                    escape = out.str();
+                }
+
+                const BodyState state = { { body->position.x, body->position.y, body->velocity.x, body->velocity.y, body->orient, body->angularVelocity } };
+                sample.bodies.push_back(state);
+            }
+            samples.push_back(sample);
+        }
+
+        return samples;
+    }
+
+    // "step <n> <bodies>" then a line per body, the floats are written with enough digits to be read back exactly
+    bool write(const std::string &filename, const Scene &scene, const std::vector<Sample> &samples) {
+        std::ofstream out(filename);
+        if (!out)
+            return false;
+
+        out << "# mphysac golden trajectory : " << scene.name << ", " << StepsCount << " steps of " << StepDuration.count() << " s\n";
+        out << "# position.x position.y velocity.x velocity.y orient angularVelocity\n";
+
+        char value[32];
+        for (const Sample &sample : samples) {
+            out << "step " << sample.step << ' ' << sample.bodies.size() << '\n';
+            for (const BodyState &state : sample.bodies) {
+                for (int f = 0; f < FieldsCount; f++) {
+                    std::snprintf(value, sizeof(value), "%.9g", (double)state.values[f]);
+                    out << (f ? " " : "") << value;
+                }
+                out << '\n';
+            }
+        }
+
+        return (bool)out;
+    }
+
+    bool read(const std::string &filename, std::vector<Sample> &samples) {
+        std::ifstream in(filename);
+        if (!in)
+            return false;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream header(line);
+            std::string keyword;
+            size_t count;
+            Sample sample;
+            if (!(header >> keyword >> sample.step >> count) || keyword != "step")
+                return false;
+
+            sample.bodies.resize(count);
+            for (BodyState &state : sample.bodies) {
+                if (!std::getline(in, line))
+                    return false;
+                std::istringstream values(line);
+                for (int f = 0; f < FieldsCount; f++)
+                    if (!(values >> state.values[f]))
+                        return false;
+            }
+            samples.push_back(sample);
+        }
+
+        return !samples.empty();
+    }
+
+    bool matches(float got, float expected, bool exact, float tolerance) {
+        if (exact)
+            return got == expected || (std::isnan(got) && std::isnan(expected));
+        return std::fabs(got - expected) <= tolerance * (1.f + std::fabs(expected));
+    }
+
+    // Prints the first divergence of the scene, returns false if there is one
+    bool compare(const Scene &scene, const std::vector<Sample> &got, const std::vector<Sample> &expected, bool exact, float tolerance) {
+        if (got.size() != expected.size()) {
+            std::cout << scene.name << ": FAILED, " << got.size() << " samples instead of " << expected.size() << std::endl;
+            return false;
+        }
+
+        float maxError = 0.f;
+        for (size_t s = 0; s < got.size(); s++) {
+            if (got[s].step != expected[s].step || got[s].bodies.size() != expected[s].bodies.size()) {
+                std::cout << scene.name << ": FAILED, " << got[s].bodies.size() << " bodies at step " << got[s].step
+                    << " instead of " << expected[s].bodies.size() << " at step " << expected[s].step << std::endl;
+                return false;
+            }
+
+            for (size_t b = 0; b < got[s].bodies.size(); b++) {
+                for (int f = 0; f < FieldsCount; f++) {
+                    const float g = got[s].bodies[b].values[f], e = expected[s].bodies[b].values[f];
+                    if (!matches(g, e, exact, tolerance)) {
+                        std::cout << scene.name << ": FAILED at step " << got[s].step << ", body " << b << ' ' << fieldNames[f]
+                            << " is " << g << " instead of " << e << std::endl;
+                        return false;
+                    }
+
+                    const float error = std::fabs(g - e);
+                    if (error > maxError)
+                        maxError = error;
+                }
+            }
+        }
+
+        std::cout << scene.name << ": ok";
+        if (!exact)
+            std::cout << " (max error " << maxError << ")";
+        std::cout << std::endl;
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string directory = "golden";
+    std::string only;
+    bool record = false;
+#ifdef MECHA_DETERMINISTIC
+    bool exact = true;
+#else
+    bool exact = false;
+#endif
+    float tolerance = 1e-3f;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg(argv[i]);
+
+        if (arg.compare(0, 6, "--dir=") == 0) {
+            directory = arg.substr(6);
+        } else if (arg.compare(0, 8, "--scene=") == 0) {
+            only = arg.substr(8);
+        } else if (arg == "--record") {
+            record = true;
+        } else if (arg == "--exact") {
+            exact = true;
+        } else if (arg.compare(0, 12, "--tolerance=") == 0) {
+            std::istringstream in(arg.substr(12));
+            if (!(in >> tolerance) || tolerance < 0.f) {
+                std::cerr << "[Error] mphysac_golden - expected a positive tolerance in " << arg << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--dir=<directory>] [--record] [--exact] [--tolerance=<value>] [--scene=<name>]" << std::endl;
+            return 1;
+        }
+    }
+
+    MPhysacWorld &world = MPhysacWorld::getInstance();
+    world.SetPhysicsTimeStep(StepDuration);
+
+    unsigned int failures = 0, run = 0;
+    for (const Scene &scene : scenes) {
+        if (!only.empty() && only != scene.name)
+            continue;
+        run++;
+
+        const std::string filename = directory + "/" + scene.name + ".golden";
+        std::string escape;
+        const std::vector<Sample> samples = simulate(scene, escape);
+
+        if (record) {
+            if (!escape.empty()) {
+                std::cerr << "[Error] mphysac_golden - " << scene.name << " not recorded, " << escape << std::endl;
+                return 1;
+            }
+
+            if (!write(filename, scene, samples)) {
+                std::cerr << "[Error] mphysac_golden - failed to write " << filename << std::endl;
+                return 1;
+            }
+            std::cout << scene.name << ": recorded " << filename << std::endl;
+            continue;
+        }
+
+        std::vector<Sample> expected;
+        if (!read(filename, expected)) {
+            std::cout << scene.name << ": FAILED, cannot read " << filename << std::endl;
+            failures++;
+            continue;
+        }
+
+        if (!compare(scene, samples, expected, exact, tolerance))
+            failures++;
+    }
+
+    world.ResetPhysics();
+
+    if (!run) {
+        std::cerr << "[Error] mphysac_golden - unknown scene " << only << std::endl;
+        return 1;
+    }
+    if (failures) {
+        std::cout << failures << " of " << run << " scenes diverged from the golden trajectories" << std::endl;
+        return 1;
+    }
+    return 0;
+}
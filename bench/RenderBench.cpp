@@ -0,0 +1,403 @@
+/*******************************************************************************************
+*   RenderBench.cpp
+*
+*   Rendering benchmarks of Painter, Sprite and AnimatedSprite on standard scenes.
+*   Usage : render_bench [--frames=<count>] [--pack=<file>] [--json=<file>]
+*   The renderer is SDL's software renderer drawing into a surface : no window, no video driver
+*   nor GPU is needed, the numbers of build machines can be compared with each other.
+*   The textures come from a generated pack holding one image per Image::ID, or from --pack.
+*   Each scene is drawn <count> frames (300 by default) after a warm up, the JSON output is meant
+*   to be kept between builds so that the batching, atlasing and culling changes can be measured.
+*
+********************************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include "AnimatedSprite.hpp"
+#include "Painter.hpp"
+#include "RenderState.hpp"
+#include "ResourcesLoader.hpp"
+#include "ResourcesPack.hpp"
+#include "Sprite.hpp"
+#include "Window.hpp"
+#include "Animation/AnimationSystem.hpp"
+
+namespace {
+    const unsigned int WarmUpFrames = 10;
+    const float FrameDuration = 1.f / 60.f;
+
+    // Size of the generated images, cut into frames of FrameSize pixels : the sprites and tiles draw the first one
+    const int ImageSize = 128;
+    const int FrameSize = 32;
+
+    const char* const GeneratedPack = "render_bench.mvpk";
+
+    struct Result {
+        const char *name;
+        size_t items;
+        unsigned int frames;
+        double msPerFrame;
+        double minMsPerFrame;
+        double drawCallsPerFrame;
+        double textureSwitchesPerFrame;
+        double culledPerFrame;
+    };
+
+    // A scene draws one frame of its content each call
+    class Scene {
+        public:
+            virtual ~Scene() {}
+
+            virtual const char* getName() const = 0;
+            virtual size_t getItemsCount() const = 0;
+            virtual void draw(Painter &painter, unsigned int frame) = 0;
+    };
+
+    Image::ID imageOf(size_t index) {
+        return (Image::ID)(index % Image::Count);
+    }
+
+    // 10k static sprites over the screen, the images interleaved : the worst order for batching
+    class SpritesScene : public Scene {
+        public:
+            SpritesScene(ResourcesLoader &rl, size_t count) {
+                std::minstd_rand random(1);
+                std::uniform_int_distribution<int> x(-FrameSize / 2, SCREEN_WIDTH - FrameSize / 2);
+                std::uniform_int_distribution<int> y(-FrameSize / 2, SCREEN_HEIGHT - FrameSize / 2);
+
+                sprites.reserve(count);
+                for (size_t i = 0; i < count; i++) {
+                    sprites.emplace_back(new Sprite(rl, imageOf(i), 0, 0, FrameSize, FrameSize));
+                    sprites.back()->setPosition(x(random), y(random));
+                }
+            }
+
+            const char* getName() const { return "sprites"; }
+            size_t getItemsCount() const { return sprites.size(); }
+
+            void draw(Painter &painter, unsigned int) {
+                for (auto &sprite : sprites)
+                    painter.draw(*sprite);
+            }
+
+        protected:
+            std::vector<std::unique_ptr<Sprite>> sprites;
+    };
+
+    // Same sprites recorded into a RenderState then submitted, the path of the pipelined game
+    class RecordedSpritesScene : public SpritesScene {
+        public:
+            RecordedSpritesScene(ResourcesLoader &rl, size_t count) :
+                SpritesScene(rl, count),
+                resources(rl),
+                recorder(nullptr)
+            {
+                recorder.record(&state);
+            }
+
+            const char* getName() const { return "sprites_recorded"; }
+
+            void draw(Painter &painter, unsigned int) {
+                state.clear();
+                for (auto &sprite : sprites)
+                    recorder.draw(*sprite);
+                painter.submit(state, resources);
+            }
+
+        private:
+            ResourcesLoader &resources;
+            Painter recorder;
+            RenderState state;
+    };
+
+    // Room of tiles four screens large, seen through a view scrolling across it : the culling
+    class TileRoomScene : public Scene {
+        public:
+            TileRoomScene(ResourcesLoader &rl) :
+                columns(SCREEN_WIDTH * 2 / FrameSize),
+                rows(SCREEN_HEIGHT * 2 / FrameSize)
+            {
+                tiles.reserve((size_t)(columns * rows));
+                for (int row = 0; row < rows; row++) {
+                    for (int column = 0; column < columns; column++) {
+                        // Runs of 8 tiles of the same image, as a tileset would give
+                        tiles.emplace_back(new Sprite(rl, imageOf((size_t)(row * columns + column) / 8), 0, 0, FrameSize, FrameSize));
+                        tiles.back()->setPosition(column * FrameSize, row * FrameSize);
+                    }
+                }
+            }
+
+            const char* getName() const { return "tile_room"; }
+            size_t getItemsCount() const { return tiles.size(); }
+
+            void draw(Painter &painter, unsigned int frame) {
+                // Back and forth along the diagonal of the room
+                const int range = 256;
+                const int offset = (int)(frame % (2 * range));
+                const int step = offset < range ? offset : 2 * range - offset;
+                const SDL_Rect view = { step * SCREEN_WIDTH / range, step * SCREEN_HEIGHT / range, SCREEN_WIDTH, SCREEN_HEIGHT };
+
+                painter.setView(view);
+                for (auto &tile : tiles)
+                    painter.draw(*tile);
+                painter.clearView();
+            }
+
+        private:
+            int columns, rows;
+            std::vector<std::unique_ptr<Sprite>> tiles;
+    };
+
+    // Bursts of animated particles from the center of the screen, restarted every 2 seconds
+    class ParticlesScene : public Scene {
+        public:
+            ParticlesScene(ResourcesLoader &rl, AnimationSystem &as, size_t count) :
+                animations(as)
+            {
+                std::minstd_rand random(1);
+                std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+                std::uniform_real_distribution<float> speed(60.f, 600.f);
+
+                as.reserve(count);
+                particles.reserve(count);
+                for (size_t i = 0; i < count; i++) {
+                    Particle particle;
+                    const float a = angle(random), s = speed(random);
+                    particle.velocity = Vector2f(std::cos(a) * s, std::sin(a) * s);
+                    // Spread over the first second, so that the bursts overlap
+                    particle.delay = (float)(i % 60) * FrameDuration;
+                    particle.sprite.reset(new AnimatedSprite(as, rl, (Animation::ID)(i % Animation::Count)));
+                    particle.sprite->setCurrentStep((uint16_t)(i % (size_t)as.getClip((Animation::ID)(i % Animation::Count)).framesCount));
+                    particles.push_back(std::move(particle));
+                }
+            }
+
+            const char* getName() const { return "particles"; }
+            size_t getItemsCount() const { return particles.size(); }
+
+            void draw(Painter &painter, unsigned int frame) {
+                animations.update(FrameDuration);
+
+                const float time = (float)frame * FrameDuration;
+                const Vector2f center((float)SCREEN_WIDTH / 2.f, (float)SCREEN_HEIGHT / 2.f);
+                // Bursts of 2 seconds, the particles out of the screen are culled as in the game
+                painter.setView(SDL_Rect{ 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT });
+                for (auto &particle : particles) {
+                    const float age = std::fmod(time + particle.delay, 2.f);
+                    const Vector2f position = center + particle.velocity * age;
+                    particle.sprite->setPosition((int)position.x, (int)position.y);
+                    painter.draw(*particle.sprite);
+                }
+                painter.clearView();
+            }
+
+        private:
+            struct Particle {
+                Vector2f velocity;
+                float delay;
+                std::unique_ptr<AnimatedSprite> sprite;
+            };
+
+            AnimationSystem &animations;
+            std::vector<Particle> particles;
+    };
+
+    // One RGBA image per Image::ID, a distinct color each so that a wrong copy shows
+    void writeGeneratedPack(const std::string &filename) {
+        ResourcesPackWriter writer;
+        std::vector<uint32_t> pixels((size_t)(ImageSize * ImageSize));
+
+        for (int i = 0; i < Image::Count; i++) {
+            for (int y = 0; y < ImageSize; y++)
+                for (int x = 0; x < ImageSize; x++)
+                    pixels[(size_t)(y * ImageSize + x)] = (uint32_t)(((x / 8 + y / 8) % 2 ? 0xC0 : 0x40) << ((i % 3) * 8)) | 0xFF000000u;
+
+            writer.add((Image::ID)i, SDL_PIXELFORMAT_RGBA32, ImageSize, ImageSize, ImageSize * 4, pixels.data());
+        }
+
+        writer.write(filename);
+    }
+
+    // Frames of FrameSize over each image, one clip per animation
+    void defineAnimations(ResourcesLoader &rl, AnimationSystem &as) {
+        std::vector<SDL_Rect> frames;
+        for (int y = 0; y < ImageSize; y += FrameSize)
+            for (int x = 0; x < ImageSize; x += FrameSize)
+                frames.push_back(SDL_Rect{ x, y, FrameSize, FrameSize });
+
+        for (int i = 0; i < Image::Count; i++)
+            rl.defineFrames((Image::ID)i, frames);
+        for (int i = 0; i < Animation::Count; i++)
+            as.defineClip((Animation::ID)i, imageOf((size_t)i), 0.1f);
+    }
+
+    Result run(SDL_Renderer *renderer, Scene &scene, unsigned int frames) {
+        typedef std::chrono::steady_clock Clock;
+
+        Painter painter(renderer);
+        for (unsigned int i = 0; i < WarmUpFrames; i++) {
+            SDL_RenderClear(renderer);
+            scene.draw(painter, i);
+            SDL_RenderPresent(renderer);
+        }
+        painter.takeDrawCallsCount();
+        painter.takeTextureSwitchesCount();
+        painter.takeCulledCount();
+
+        double total = 0., minimum = 1e300;
+        for (unsigned int i = 0; i < frames; i++) {
+            const Clock::time_point start = Clock::now();
+            SDL_RenderClear(renderer);
+            scene.draw(painter, WarmUpFrames + i);
+            SDL_RenderPresent(renderer);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            total += ms;
+            if (ms < minimum)
+                minimum = ms;
+        }
+
+        Result result;
+        result.name = scene.getName();
+        result.items = scene.getItemsCount();
+        result.frames = frames;
+        result.msPerFrame = total / frames;
+        result.minMsPerFrame = minimum;
+        result.drawCallsPerFrame = (double)painter.takeDrawCallsCount() / frames;
+        result.textureSwitchesPerFrame = (double)painter.takeTextureSwitchesCount() / frames;
+        result.culledPerFrame = (double)painter.takeCulledCount() / frames;
+
+        return result;
+    }
+
+    void writeJson(std::ostream &out, const std::vector<Result> &results) {
+        out << "{\n  \"benchmark\": \"render\",\n  \"renderer\": \"software\",\n  \"scenes\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            out << "    { \"name\": \"" << r.name << "\", \"items\": " << r.items << ", \"frames\": " << r.frames
+                << ", \"ms_per_frame\": " << r.msPerFrame << ", \"min_ms_per_frame\": " << r.minMsPerFrame
+                << ", \"draw_calls_per_frame\": " << r.drawCallsPerFrame << ", \"texture_switches_per_frame\": " << r.textureSwitchesPerFrame
+                << ", \"culled_per_frame\": " << r.culledPerFrame << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}\n";
+    }
+
+    std::vector<Result> runScenes(SDL_Renderer *renderer, const std::string &packFile, unsigned int frames) {
+        ResourcesLoader resources(renderer, packFile, "");
+        AnimationSystem animations(resources);
+        defineAnimations(resources, animations);
+
+        std::vector<Result> results;
+        {
+            SpritesScene scene(resources, 10000);
+            results.push_back(run(renderer, scene, frames));
+        }
+        {
+            RecordedSpritesScene scene(resources, 10000);
+            results.push_back(run(renderer, scene, frames));
+        }
+        {
+            TileRoomScene scene(resources);
+            results.push_back(run(renderer, scene, frames));
+        }
+        {
+            ParticlesScene scene(resources, animations, 4096);
+            results.push_back(run(renderer, scene, frames));
+        }
+
+        return results;
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned int frames = 300;
+    std::string packFile, jsonFile;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg(argv[i]);
+
+        if (arg.compare(0, 9, "--frames=") == 0) {
+            std::istringstream in(arg.substr(9));
+            if (!(in >> frames) || frames == 0) {
+                std::cerr << "[Error] render_bench - expected a frame count in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 7, "--pack=") == 0) {
+            packFile = arg.substr(7);
+        } else if (arg.compare(0, 7, "--json=") == 0) {
+            jsonFile = arg.substr(7);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--frames=<count>] [--pack=<file>] [--json=<file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    SDL_SetMainReady();
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_RGBA8888);
+    SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        std::cerr << "[Error] render_bench - failed to create the software renderer: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(target);
+        return 1;
+    }
+
+    const bool generated = packFile.empty();
+    std::vector<Result> results;
+    int res = 0;
+    try {
+        if (generated) {
+            packFile = GeneratedPack;
+            writeGeneratedPack(packFile);
+        }
+        results = runScenes(renderer, packFile, frames);
+    } catch(std::exception &e) {
+        std::cerr << "[Error] render_bench - " << e.what() << std::endl;
+        res = 1;
+    }
+
+    if (generated)
+        std::remove(GeneratedPack);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_Quit();
+
+    if (res)
+        return res;
+
+    std::cout << std::left << std::setw(18) << "scene" << std::right << std::setw(8) << "items" << std::setw(12) << "ms/frame"
+        << std::setw(14) << "min ms/frame" << std::setw(12) << "draw calls" << std::setw(12) << "switches" << std::setw(10) << "culled" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const Result &r : results) {
+        std::cout << std::left << std::setw(18) << r.name << std::right << std::setw(8) << r.items << std::setw(12) << r.msPerFrame
+            << std::setw(14) << r.minMsPerFrame << std::setw(12) << r.drawCallsPerFrame << std::setw(12) << r.textureSwitchesPerFrame
+            << std::setw(10) << r.culledPerFrame << std::endl;
+    }
+
+    if (!jsonFile.empty()) {
+        std::ofstream out(jsonFile);
+        if (!out) {
+            std::cerr << "[Error] render_bench - failed to write " << jsonFile << std::endl;
+            return 1;
+        }
+        writeJson(out, results);
+    }
+
+    return 0;
+}
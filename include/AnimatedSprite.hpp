@@ -1,47 +1,40 @@
 #ifndef MECHA_ANIMATEDSPRITE_HPP
 #define MECHA_ANIMATEDSPRITE_HPP
 
-#include <map>
-#include <vector>
-#include <chrono>
+#include <stdint.h>
 
 #include "Drawable.hpp"
 #include "ResourcesID.hpp"
+#include "TextureHandle.hpp"
 #include "Utils/Vector.hpp"
 
-#include <iostream>
-
 class Painter;
 struct SDL_Rect;
 struct SDL_Texture;
 class ResourcesLoader;
+class AnimationSystem;
 
+// Draws the current frame of an animation state, the state itself being advanced by the AnimationSystem
 class AnimatedSprite : public Drawable {
-	private:
-		static std::map<Image::ID, std::vector<SDL_Rect>> srcRects;
-
 	public:
-		// speed is ms / step
-		AnimatedSprite(ResourcesLoader &rl, Image::ID id, const std::vector<SDL_Rect>& sRects, std::chrono::duration<float> stepD);
+		AnimatedSprite(AnimationSystem &as, ResourcesLoader &rl, Animation::ID clip);
 		virtual ~AnimatedSprite();
 
+		AnimatedSprite(const AnimatedSprite&) = delete;
+		AnimatedSprite& operator=(const AnimatedSprite&) = delete;
+
 		inline void setPosition(int x, int y) { dstRect.x = x; dstRect.y = y; }
 		inline void setPosition(const Vector2i &pos) { dstRect.x = pos.x; dstRect.y = pos.y; }
 
-		inline void setCurrentStep(size_t step) { currentStep = step; }
-
-		void update(const std::chrono::duration<float>& dt);
+		void setCurrentStep(uint16_t step);
 
 		void draw(const Painter& painter) const;
 
 	private:	
 		SDL_Rect dstRect;
-		ResourcesLoader &resources;
-		Image::ID imgID;
-
-		size_t currentStep;
-		const std::chrono::duration<float> stepDuration;
-		std::chrono::duration<float> dtStep;
+		AnimationSystem &animations;
+		TextureHandle texture;
+		uint32_t state;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,72 @@
+#ifndef MECHA_ANIMATIONSYSTEM_HPP
+#define MECHA_ANIMATIONSYSTEM_HPP
+
+#include <stdint.h>
+#include <vector>
+
+#include <SDL.h>
+
+#include "ResourcesID.hpp"
+
+class ResourcesLoader;
+
+// One clip per Animation::ID, its frames are contiguous in the frames table
+struct AnimationClip {
+	Image::ID image;
+	float stepDuration;     // Seconds per frame
+	uint32_t firstFrame;    // Index in the frames table
+	uint32_t framesCount;   // 0 while the clip is not defined
+};
+
+// State of one running animation, kept small so that the update is a linear pass over a flat array
+struct AnimationState {
+	float elapsed;          // Time spent on the current frame, in seconds
+	uint16_t clip;          // Animation::ID, or AnimationSystem::FreeState
+	uint16_t frame;         // Index in the clip
+};
+
+/**
+ * Advances every animation of the game in one loop.
+ * The clips are compiled from the frames defined in the ResourcesLoader, and compiled again when they are reloaded.
+ */
+class AnimationSystem {
+	public:
+		static const uint16_t FreeState = 0xFFFF;
+
+	public:
+		AnimationSystem(ResourcesLoader &rl);
+
+		// The frames of the clip are the frames defined for its image
+		void defineClip(Animation::ID clip, Image::ID image, float stepDuration);
+
+		// Returns the index of a new state, stable until destroyed
+		uint32_t create(Animation::ID clip);
+		void destroy(uint32_t state);
+		// So that creating count states does not allocate
+		void reserve(size_t count) { states.reserve(count); freeStates.reserve(count); }
+
+		// The frame is wrapped to the frames of the clip, as the update does
+		void setFrame(uint32_t state, uint16_t frame);
+
+		void update(float dt);
+
+		const SDL_Rect& getFrame(uint32_t state) const { const AnimationState &s = states[state]; return frames[clips[s.clip].firstFrame + s.frame]; }
+		const AnimationClip& getClip(Animation::ID clip) const { return clips[clip]; }
+
+		size_t getStatesCount() const { return states.size() - freeStates.size(); }
+
+	private:
+		void compile();
+
+	private:
+		ResourcesLoader &resources;
+		unsigned int framesVersion;         // Version of the loader frames the clips were compiled from
+
+		std::vector<AnimationClip> clips;   // Indexed by Animation::ID
+		std::vector<SDL_Rect> frames;
+
+		std::vector<AnimationState> states;
+		std::vector<uint32_t> freeStates;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef MECHA_COMPONENTPOOL_HPP
+#define MECHA_COMPONENTPOOL_HPP
+
+#include <stdint.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace ECS {
+	// Index in the low bits, version of the index in the high bits, so that a destroyed entity is never mistaken for its successor
+	typedef uint32_t Entity;
+
+	const Entity NullEntity = 0xFFFFFFFF;
+	const uint32_t IndexBits = 20;
+	const uint32_t IndexMask = (1u << IndexBits) - 1;
+
+	inline uint32_t indexOf(Entity e) { return e & IndexMask; }
+	inline uint32_t versionOf(Entity e) { return e >> IndexBits; }
+
+	// Type erased part of the pools, used by the Registry to destroy the components of an entity
+	class BasePool {
+		public:
+			virtual ~BasePool() {}
+
+			virtual bool has(Entity e) const = 0;
+			virtual void remove(Entity e) = 0;
+			virtual size_t size() const = 0;
+	};
+
+	/**
+	 * Sparse set : the components are packed in a dense array, the sparse array gives the position of the component of each entity index.
+	 * Iterating a pool is a linear pass over contiguous components, adding and removing are O(1) (the last component fills the hole).
+	 */
+	template<typename T>
+	class ComponentPool : public BasePool {
+		public:
+			// Called before a component is removed, its entity being destroyed or not
+			typedef std::function<void(Entity, T&)> Hook;
+
+		public:
+			ComponentPool() {}
+
+			ComponentPool(const ComponentPool&) = delete;
+			ComponentPool& operator=(const ComponentPool&) = delete;
+
+			// Replaces the component if the entity already has one, the remove hook releases what the replaced one owned
+			T& add(Entity e, T&& component) {
+				const uint32_t index = indexOf(e);
+				if (index >= sparse.size())
+					sparse.resize(index + 1, Absent);
+
+				if (has(e) && onRemove)
+					onRemove(e, components[sparse[index]]);
+
+				// The hook may have removed it
+				if (has(e)) {
+					components[sparse[index]] = std::move(component);
+					return components[sparse[index]];
+				}
+
+				sparse[index] = (uint32_t)components.size();
+				entities.push_back(e);
+				components.push_back(std::move(component));
+
+				return components.back();
+			}
+
+			void remove(Entity e) override {
+				if (!has(e))
+					return;
+
+				const uint32_t position = sparse[indexOf(e)];
+				if (onRemove)
+					onRemove(e, components[position]);
+
+				// The hook may have removed it already
+				if (!has(e))
+					return;
+
+				const Entity last = entities.back();
+				components[position] = std::move(components.back());
+				entities[position] = last;
+				sparse[indexOf(last)] = position;
+
+				components.pop_back();
+				entities.pop_back();
+				sparse[indexOf(e)] = Absent;
+			}
+
+			bool has(Entity e) const override {
+				const uint32_t index = indexOf(e);
+				return index < sparse.size() && sparse[index] != Absent && entities[sparse[index]] == e;
+			}
+
+			// The entity must have the component
+			T& get(Entity e) { return components[sparse[indexOf(e)]]; }
+			const T& get(Entity e) const { return components[sparse[indexOf(e)]]; }
+
+			size_t size() const override { return components.size(); }
+			// Count is the number of entities of the registry, which bounds the entity indices
+			void reserve(size_t count) { sparse.reserve(count); components.reserve(count); entities.reserve(count); }
+
+			// Dense access, in the iteration order
+			Entity entityAt(size_t position) const { return entities[position]; }
+			T& at(size_t position) { return components[position]; }
+			const T& at(size_t position) const { return components[position]; }
+
+			void setOnRemove(const Hook& hook) { onRemove = hook; }
+
+		private:
+			enum : uint32_t { Absent = 0xFFFFFFFF };
+
+			std::vector<uint32_t> sparse;   // Entity index -> position in the dense arrays
+			std::vector<Entity> entities;   // Dense, entity of each component
+			std::vector<T> components;      // Dense
+			Hook onRemove;
+	};
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef MECHA_COMPONENTS_HPP
+#define MECHA_COMPONENTS_HPP
+
+#include <stdint.h>
+
+#include "TextureHandle.hpp"
+#include "Utils/Vector.hpp"
+
+class MPhysacBody;
+
+/**
+ * Components of the entities : plain data, small and cheap to move so that the pools stay dense.
+ * Most are trivially movable, Sprite holds a TextureHandle whose move only hands over the texture reference.
+ */
+namespace ECS {
+	struct Transform {
+		Vector2f position;
+		Vector2f velocity;      // Pixels per second, copied from and to the physics body if the entity has one
+	};
+
+	// The body is destroyed with the component
+	struct PhysicsHandle {
+		MPhysacBody *body;
+	};
+
+	// Drawn at the transform position with the current frame of an AnimationSystem state, destroyed with the component
+	struct Sprite {
+		TextureHandle texture;
+		uint32_t animation;
+	};
+
+	struct Vitals {
+		int lifePoints;
+		int oxygenLevel;
+	};
+
+	struct AI {
+		enum Behaviour : uint8_t {
+			Idle,
+			Patrol,     // Goes back and forth around origin
+			Chase       // Runs to the target once it is in range
+		};
+
+		Behaviour behaviour;
+		float speed;            // Pixels per second
+		float range;
+		Vector2f origin;
+	};
+
+	// Entity of a room next to the current one : no physics body, stepped at a low rate by updateAsleep
+	struct Asleep {
+		bool hadBody;           // Given back its physics body when woken up
+	};
+
+	// Entity moved by the keyboard, kept when its life points are over (the game decides what happens)
+	struct PlayerControl {};
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef MECHA_REGISTRY_HPP
+#define MECHA_REGISTRY_HPP
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ECS/ComponentPool.hpp"
+
+namespace ECS {
+	/**
+	 * Creates the entities and owns one ComponentPool per component type.
+	 * Components are plain structs, the behaviour lives in the systems which iterate the pools in bulk.
+	 */
+	class Registry {
+		public:
+			Registry() : alive(0) {}
+			~Registry();    // Destroys the remaining entities, so that the remove hooks release what they own
+
+			Registry(const Registry&) = delete;
+			Registry& operator=(const Registry&) = delete;
+
+			Entity create();
+			// Removes all the components of the entity, its index is reused with a new version
+			void destroy(Entity e);
+			bool valid(Entity e) const { return indexOf(e) < slots.size() && slots[indexOf(e)] == e; }
+
+			size_t size() const { return alive; }
+			// So that creating count more entities does not allocate (the component pools are reserved separately)
+			void reserve(size_t count) { slots.reserve(slots.size() + count); freeIndices.reserve(slots.size() + count); }
+			// Bound of the entity indices until the next allocation
+			size_t capacity() const { return slots.capacity(); }
+
+			// Components are aggregates : assign<Transform>(e, position, velocity)
+			template<typename T, typename... Args>
+			T& assign(Entity e, Args&&... args) { return pool<T>().add(e, T{ std::forward<Args>(args)... }); }
+
+			template<typename T>
+			void remove(Entity e) { pool<T>().remove(e); }
+
+			template<typename T>
+			bool has(Entity e) const {
+				const unsigned int type = typeID<T>();
+				return type < pools.size() && pools[type] && pools[type]->has(e);
+			}
+
+			template<typename... Ts>
+			bool hasAll(Entity e) const {
+				(void)e; // Unused by an empty pack
+				bool all = true;
+				using expand = int[];
+				(void)expand{ 0, (all = all && has<Ts>(e), 0)... };
+				return all;
+			}
+
+			// The entity must have the component
+			template<typename T>
+			T& get(Entity e) { return pool<T>().get(e); }
+
+			template<typename T>
+			ComponentPool<T>& pool() {
+				const unsigned int type = typeID<T>();
+				if (type >= pools.size())
+					pools.resize(type + 1);
+				if (!pools[type])
+					pools[type].reset(new ComponentPool<T>());
+
+				return static_cast<ComponentPool<T>&>(*pools[type]);
+			}
+
+			// Calls func(entity, T&, Others&...) for each entity having all the components.
+			// The pool of T drives the iteration, it should be the smallest one.
+			// Entities must not be created nor destroyed by func : collect them and do it after the loop.
+			template<typename T, typename... Others, typename Func>
+			void each(Func func) {
+				ComponentPool<T> &driver = pool<T>();
+
+				for (size_t i = 0; i < driver.size(); ++i) {
+					const Entity e = driver.entityAt(i);
+					if (hasAll<Others...>(e))
+						func(e, driver.at(i), get<Others>(e)...);
+				}
+			}
+
+		private:
+			static unsigned int nextTypeID();
+
+			template<typename T>
+			static unsigned int typeID() {
+				static const unsigned int id = nextTypeID();
+				return id;
+			}
+
+		private:
+			// Live entity of each index, or the version of its next entity with the index bits set to IndexMask once destroyed
+			std::vector<Entity> slots;
+			std::vector<uint32_t> freeIndices;
+			size_t alive;
+
+			std::vector<std::unique_ptr<BasePool>> pools;   // Indexed by component type
+	};
+}
+
+#endif
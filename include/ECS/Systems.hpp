@@ -0,0 +1,32 @@
+#ifndef MECHA_SYSTEMS_HPP
+#define MECHA_SYSTEMS_HPP
+
+#include "ECS/Registry.hpp"
+#include "ECS/Components.hpp"
+#include "Utils/Vector.hpp"
+
+class AnimationSystem;
+class Painter;
+
+/**
+ * Systems : each one is a single pass over the pools of the components it uses.
+ */
+namespace ECS {
+	// Destroys the physics bodies and the animation states along with their components
+	void connectHooks(Registry& registry, AnimationSystem& animations);
+
+	// Sets the velocity of the AI driven entities (and of their physics body), target being the player position
+	void updateAI(Registry& registry, const Vector2f& target);
+	// Moves the entities without a physics body by their velocity
+	void integrateMovement(Registry& registry, float dt);
+	// AI and movement of the asleep entities, which the two systems above skip. Meant to run every few ticks with their summed dt.
+	void updateAsleep(Registry& registry, const Vector2f& target, float dt);
+	// Copies the position of the physics bodies into the transforms, once the physics stepped
+	void syncPhysics(Registry& registry);
+	// Destroys the entities without life points left
+	void removeDead(Registry& registry);
+
+	void drawSprites(Registry& registry, const AnimationSystem& animations, const Painter& painter);
+}
+
+#endif
@@ -8,13 +8,13 @@
 #ifndef MECHA_PLAYERENTITY_HPP
 #define MECHA_PLAYERENTITY_HPP
 
-#include <chrono>
-
-#include "MovableEntity.hpp"
-#include "Drawable.hpp"
-#include "AnimatedSprite.hpp"
+#include "ECS/Registry.hpp"
+#include "ECS/Components.hpp"
 #include "Input/InputTarget.hpp"
 
+class AnimationSystem;
+class ResourcesLoader;
+
 enum PlayerAction {
     MoveUp,
     MoveDown,
@@ -22,31 +22,28 @@ enum PlayerAction {
     MoveRight,
 };
 
-class PlayerEntity : public Drawable, public InputTarget<PlayerAction> {
+// The player is an entity of the registry like the others, this class only binds the keyboard to it
+class PlayerEntity : public InputTarget<PlayerAction> {
     public:
-        int getLifePoints(){return lifePoints;}
-        void setLifePoints(int newVal){lifePoints = newVal;}
-        int getOxygenLevel(){return oxygenLevel;}
-        void setOxygenLevel(int newVal){oxygenLevel = newVal;}
+        int getLifePoints() const {return registry.get<ECS::Vitals>(entity).lifePoints;}
+        void setLifePoints(int newVal){registry.get<ECS::Vitals>(entity).lifePoints = newVal;}
+        int getOxygenLevel() const {return registry.get<ECS::Vitals>(entity).oxygenLevel;}
+        void setOxygenLevel(int newVal){registry.get<ECS::Vitals>(entity).oxygenLevel = newVal;}
 
-        void move(const Vector2f &newPos) { position += newPos; playerSprite->setPosition((Vector2i)position); }
-        void setPosition(const Vector2f &newPos) { position = newPos; playerSprite->setPosition((Vector2i)position); }
-        void loadSprite(ResourcesLoader &rl);
-        void draw(const Painter& painter) const { playerSprite->draw(painter); }
+        void move(const Vector2f &offset) { registry.get<ECS::Transform>(entity).position += offset; }
+        void setPosition(const Vector2f &newPos) { registry.get<ECS::Transform>(entity).position = newPos; }
+        const Vector2f& getPosition() const { return registry.get<ECS::Transform>(entity).position; }
 
-        void update(const std::chrono::duration<float> &dt) { playerSprite->update(dt); }
+        ECS::Entity getEntity() const { return entity; }
 
         void initInput();
 
-        PlayerEntity(ResourcesLoader& rl);
+        PlayerEntity(ECS::Registry& registry, ResourcesLoader& rl, AnimationSystem& as);
         ~PlayerEntity();
 
-        Vector2f position;
-
     private:
-        int lifePoints;
-        int oxygenLevel;
-        AnimatedSprite *playerSprite;
+        ECS::Registry &registry;
+        ECS::Entity entity;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,43 +1,109 @@
 #ifndef MECHA_GAME_HPP
 #define MECHA_GAME_HPP
 
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <stdint.h> // Or uint32_t is not defined => C3646
 
+#include "GameOptions.hpp"
 #include "Window.hpp"
 #include "Renderer.hpp"
 #include "Painter.hpp"
+#include "PerfOverlay.hpp"
+#include "RenderCapture.hpp"
+#include "RenderState.hpp"
 #include "ResourcesLoader.hpp"
 #include "Sprite.hpp"
+#include "Animation/AnimationSystem.hpp"
+#include "ECS/Registry.hpp"
+#include "MCamera/MCamera.hpp"
 #include "Entity/PlayerEntity.hpp"
+#include "Input/InputLog.hpp"
+#include "Utils/FrameArena.hpp"
+#include "Utils/FramePacer.hpp"
+#include "Utils/Metrics.hpp"
+#include "Utils/TripleBuffer.hpp"
+#include "World/Spawner.hpp"
+#include "World/StressScene.hpp"
+#include "World/WorldManager.hpp"
 
 class Game {
 	public:
-		Game();
+		Game(const GameOptions& options = GameOptions());
 		~Game();
 
-		void run();
+		// Returns the exit status : 2 when a headless run allocated on a hot path (allocation tracker builds), 0 otherwise
+		int run();
 
 	private:
+		// Copy of the keyboard state, handed from the main thread to the simulation thread
+		struct KeyboardState {
+			Uint8 keys[SDL_NUM_SCANCODES];
+		};
+
+	private:
+		void runSerial();
+		// Simulates the given number of ticks as fast as possible, with the scripted inputs
+		void runHeadless();
+		// Renders on the calling thread while the simulation runs on a worker, one tick ahead
+		void runPipelined();
+		void simulate();
+
 		void update(const std::chrono::duration<float> &dt);
+		void updateRoom(const Vector2f &playerPosition);
+		// Camera bounds and simulation LOD of the entered room
+		void enterRoom(const RoomData &room, const Vector2f &playerPosition);
 		void processInput();
+		// Starts the input tick of the player, from the keyboard or the replayed log. Returns false once the replay is over.
+		bool processPlayerInput(const Uint8 *kbState);
 		void setUpdateFPS(unsigned int fps) { updateFrameDuration = std::chrono::duration<float>(1.f / (float)fps); }
 		void setRenderFPS(unsigned int fps) { renderFrameDuration = std::chrono::duration<float>(1.f / (float)fps); }
-		void draw();
+		// Draws a snapshot recorded by the simulation thread, or the live entities if nullptr
+		void draw(const std::chrono::duration<float> &dt, const RenderState *snapshot = nullptr);
 
 		void updateStats(const std::chrono::duration<float> &dtU, const std::chrono::duration<float> &dtR);
+		// Appends the snapshot published by the last metrics period to the metrics file, if any. Called by the main loops, out of the ticks.
+		void writeMetrics();
+		// Called after each frame presented (each tick headless), only the first ends the startup timeline
+		void endStartup();
 
 	private:
+		GameOptions options;
+
 		// Must be declared in this order (to have a correct destruction order)
-		Window win;
-		Renderer renderer;
+		std::unique_ptr<Window> win;            // nullptr when headless
+		std::unique_ptr<Renderer> renderer;     // nullptr when headless
 		Painter painter;
+		PerfOverlay overlay;                    // Toggled with F3, its font is a texture of the renderer
+		std::unique_ptr<RenderCaptureWriter> capture;   // nullptr unless capturing, closed once the frames are written
 		ResourcesLoader resources;
+		AnimationSystem animations;
+		ECS::Registry registry;
+		Spawner spawner;
+		WorldManager world;
+		std::unique_ptr<StressScene> stress;    // nullptr unless --stress, destroyed before the entities it spawned
 
 		PlayerEntity testPlayer;
+		MCamera camera;                         // Follows the player, owned by the rendering thread
 
-		bool running;
+		std::unique_ptr<InputRecorder> recorder;    // nullptr unless recording
+		std::unique_ptr<InputReplayer> replayer;    // nullptr unless replaying
+
+		std::atomic<bool> running;
 		std::chrono::duration<float> updateFrameDuration, renderFrameDuration;
+		FramePacer pacer;
+
+		// Scratch memory of the current frame, one per thread running the game
+		FrameArena mainArena, simulationArena;
+
+		TripleBuffer<KeyboardState> keyboardStates;
+		TripleBuffer<RenderState> renderStates;
+		TripleBuffer<Metrics::Snapshot> metricsSnapshots;  // Taken by the update, written by the main thread
+
+		float prefetchLookahead; // Distance to a door under which the room behind is prefetched
+		unsigned long long ticks; // Updates run, paces the metrics snapshots
+		std::atomic<float> lastDrawCost; // Milliseconds, the stress scene adds it to the cost of a tick
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef MECHA_GAMEOPTIONS_HPP
+#define MECHA_GAMEOPTIONS_HPP
+
+#include <string>
+
+#include "Utils/FramePacer.hpp"
+
+/**
+ * Settings given on the command line.
+ */
+struct GameOptions {
+	GameOptions();
+
+	// --pacing=<spin|sleep|vsync|powersave>
+	// --pipeline : simulation on a worker thread, rendering on the main thread
+	// --headless : no window nor renderer, the ticks are simulated as fast as possible (always set by the headless build)
+	// --ticks=<count> : length of a headless run
+	// --script=<file> : InputScript played by a headless run
+	// --record=<file> : writes the player inputs of each tick to an input log
+	// --replay=<file> : plays an input log instead of the keyboard, the game stops at its end
+	// --metrics=<file> : appends a snapshot of the runtime metrics every 10 s of game and at exit (JSON lines if it ends with .json, CSV otherwise)
+	// --stress[=<mix>] : grows a StressScene until the ticks go over the budget, then reports and quits (--ticks is ignored)
+	// --stress-budget=<ms> : cost of a tick the stress scene must stay under, 16.6 ms by default
+	// --capture=<file> : writes the draw commands of the rendered frames to a render capture, replayed by mecha_replay
+	// --capture-frames=<count> : frames written to the capture, 600 by default
+	// --startup-timeline : prints the time spent in each startup stage once the first frame is presented (or the first tick headless)
+	// Throws on an unknown argument, or on --script with --replay
+	static GameOptions parse(int argc, char** argv);
+
+	FramePacer::Mode pacing;
+	bool pipelined;
+
+	bool headless;
+	unsigned long long ticks;
+	std::string inputScript;
+
+	std::string recordFile;
+	std::string replayFile;
+
+	std::string metricsFile;
+
+	bool stress;
+	std::string stressMix;          // Empty for StressScene::defaultMix
+	float stressBudget;             // Milliseconds
+
+	std::string captureFile;
+	unsigned long long captureFrames;
+
+	bool startupTimeline;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef MECHA_ACTIONSTATE_HPP
+#define MECHA_ACTIONSTATE_HPP
+
+#include <stdint.h>
+
+#include <SDL.h>
+
+/**
+ * State of the actions of an InputTarget during one tick, one bit per action.
+ * The edges come from the events when they are polled, and from the keyboard state changes otherwise,
+ * so that a key tapped between two ticks is still seen as pressed and released.
+ */
+struct ActionState {
+	enum : unsigned int { MaxActions = 32 };
+
+	unsigned long long tick;
+	uint32_t down;                      // Held at the end of the tick
+	uint32_t pressed;                   // Went down during the tick
+	uint32_t released;                  // Went up during the tick
+	Uint32 pressedAt[MaxActions];       // SDL timestamp (ms) of the last press of each action
+
+	bool isDown(unsigned int action) const { return (down >> action) & 1u; }
+	bool wasPressed(unsigned int action) const { return (pressed >> action) & 1u; }
+	bool wasReleased(unsigned int action) const { return (released >> action) & 1u; }
+};
+
+#endif
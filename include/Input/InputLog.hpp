@@ -0,0 +1,68 @@
+#ifndef MECHA_INPUTLOG_HPP
+#define MECHA_INPUTLOG_HPP
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "Input/ActionState.hpp"
+
+/**
+ * Binary log of the action states of a play session, replayed to run the same session again.
+ * Only the ticks where something changed are written, as varints :
+ *   <ticks since the previous record> <down XOR previous down> <actions both pressed and released>
+ * the pressed and released masks being rebuilt from the down changes. A last record with empty masks marks the end.
+ * The file starts with "MVIR", the format version and the tick duration in microseconds.
+ */
+class InputRecorder {
+	public:
+		// Throws if the file cannot be created
+		InputRecorder(const std::string& filename, uint32_t tickMicroseconds);
+		~InputRecorder(); // Writes the end of the log
+
+		InputRecorder(const InputRecorder&) = delete;
+		InputRecorder& operator=(const InputRecorder&) = delete;
+
+		// Once per tick, after the state of the tick is built
+		void record(const ActionState& state);
+
+		unsigned long long getTicksCount() const { return tick; }
+
+	private:
+		void writeVarint(uint64_t value);
+
+	private:
+		std::ofstream file;
+		unsigned long long tick, lastRecord;
+		uint32_t previousDown;
+};
+
+class InputReplayer {
+	public:
+		// Throws if the file cannot be read or is not an input log. The log is loaded at once.
+		explicit InputReplayer(const std::string& filename);
+
+		// Tick duration of the recorded session, the replay is only exact at the same rate
+		uint32_t getTickMicroseconds() const { return tickMicroseconds; }
+
+		// Fills the masks of the next tick, returns false once the log is over
+		bool next(ActionState& state);
+
+	private:
+		uint64_t readVarint();
+		void readRecord();
+
+	private:
+		std::string filename;
+		std::vector<unsigned char> data;
+		size_t offset;
+		uint32_t tickMicroseconds;
+
+		unsigned long long tick, nextRecord;    // nextRecord is the tick of the record read ahead
+		uint32_t down, nextXor, nextTaps;
+		bool ended;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef MECHA_INPUTSCRIPT_HPP
+#define MECHA_INPUTSCRIPT_HPP
+
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+/**
+ * Keyboard driven by a text file instead of a player, for the headless runs.
+ * One command per line, '#' starting a comment :
+ *   <tick> press <key>
+ *   <tick> release <key>
+ *   <tick> quit
+ * The keys are the SDL scancode names (Up, Left, Space...).
+ */
+class InputScript {
+	public:
+		InputScript() : next(0) {}
+
+		// Throws if the file cannot be read or is malformed
+		void loadFromFile(const std::string& filename);
+
+		// Applies the commands of the ticks up to tick to keys (indexed by scancode), returns false once the script quits
+		bool apply(unsigned long long tick, Uint8* keys);
+
+	private:
+		struct Command {
+			enum Type { Press, Release, Quit };
+
+			unsigned long long tick;
+			Type type;
+			SDL_Scancode key;
+		};
+
+	private:
+		std::vector<Command> commands;  // Sorted by tick
+		size_t next;
+};
+
+#endif
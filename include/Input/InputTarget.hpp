@@ -1,14 +1,18 @@
 #ifndef MECHA_INPUTTARGET_HPP
 #define MECHA_INPUTTARGET_HPP
 
+#include <array>
 #include <functional>
-#include <unordered_map>
+#include <vector>
 #include <SDL.h>
 
 #include "Input/Action.hpp"
+#include "Input/ActionState.hpp"
 
 /**
  * Input management inspired by https://github.com/Krozark/SFML-book/blob/master/05_GUI/include/SFML-Book/ActionTarget.hpp
+ * The bindings are compiled into a table indexed by scancode, so that dispatching an event is a table lookup.
+ * ActionKey must be an enum whose values are below ActionState::MaxActions.
  */
 
 template<typename ActionKey>
@@ -17,21 +21,50 @@ class InputTarget {
 		InputTarget<ActionKey>(const InputTarget<ActionKey>&) = delete;
 		InputTarget<ActionKey>& operator=(const InputTarget<ActionKey>&) = delete;
 
-		InputTarget<ActionKey>() {}
+		InputTarget<ActionKey>();
 
-		bool processEvent(const SDL_Event& event) const;
-		void processRealTimeEvents() const;
+		// To be called for each polled event, the key repeats are ignored
+		bool processEvent(const SDL_Event& event);
+		// Once per tick : starts the action state of the tick and runs the real time callbacks
+		void processRealTimeEvents();
+		// From a copy of the keyboard state, for the threads that do not poll the events
+		void processRealTimeEvents(const Uint8* kbState);
+		// Replaces the events and the keyboard for a tick with recorded masks (see InputReplayer)
+		void processActionState(const ActionState& recorded);
+
+		// State of the last tick started by processRealTimeEvents
+		const ActionState& getActionState() const { return state; }
+		bool isDown(ActionKey key) const { return state.isDown(key); }
+		bool wasPressed(ActionKey key) const { return state.wasPressed(key); }
+		bool wasReleased(ActionKey key) const { return state.wasReleased(key); }
 
 		using FuncCallback = std::function<void()>;
+		// Throws if the key is out of the action state. A key already bound keeps its first binding.
 		void bind(const ActionKey& key, const Action &a, const FuncCallback& callback);
 
 	private:
-		std::unordered_map<ActionKey, FuncCallback> cbPoll;
-		std::unordered_map<ActionKey, FuncCallback> cbRealTime;
+		struct Binding {
+			ActionKey key;
+			Action action;
+			FuncCallback callback;
+		};
+
+		void compile();
+
+	private:
+		std::vector<Binding> cbPoll;            // Sorted by scancode
+		std::vector<Binding> cbRealTime;
+
+		// cbPoll[pollIndex[scancode]] to cbPoll[pollIndex[scancode + 1]] are the bindings of the scancode
+		std::array<Uint16, SDL_NUM_SCANCODES + 1> pollIndex;
+		// Scancode of each bound action, SDL_SCANCODE_UNKNOWN for the others
+		std::array<SDL_Scancode, ActionState::MaxActions> actionKeys;
+		uint32_t bound;
 
-		std::unordered_map<ActionKey, Action> actionMap;
+		ActionState state;
+		uint32_t pendingPressed, pendingReleased;   // Edges seen in the events since the last tick
 };
 
 #include "Input/InputTarget.tpp"
 
-#endif
\ No newline at end of file
+#endif
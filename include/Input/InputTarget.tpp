@@ -1,14 +1,54 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+template<typename ActionKey>
+InputTarget<ActionKey>::InputTarget() :
+	bound(0),
+	pendingPressed(0),
+	pendingReleased(0)
+{
+	pollIndex.fill(0);
+	actionKeys.fill(SDL_SCANCODE_UNKNOWN);
+
+	state.tick = 0;
+	state.down = state.pressed = state.released = 0;
+	std::fill(state.pressedAt, state.pressedAt + ActionState::MaxActions, 0);
+}
+
 template<typename ActionKey>
-bool InputTarget<ActionKey>::processEvent(const SDL_Event& event) const {
+bool InputTarget<ActionKey>::processEvent(const SDL_Event& event) {
 	if (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP)
 		return false;
-	
+
+	const SDL_Scancode scancode = event.key.keysym.scancode;
+	if (scancode < 0 || scancode >= SDL_NUM_SCANCODES)
+		return false;
+
+	// The repeats of a held key are not presses : neither edges of the bound actions nor poll callbacks,
+	// the poll bindings fire once per edge as when an ActionState is replayed
+	if (event.key.repeat)
+		return false;
+
+	for (unsigned int a = 0; a < ActionState::MaxActions; ++a) {
+		if (actionKeys[a] != scancode)
+			continue;
+
+		if (event.type == SDL_KEYDOWN) {
+			pendingPressed |= 1u << a;
+			state.pressedAt[a] = event.key.timestamp;
+		} else {
+			pendingReleased |= 1u << a;
+		}
+	}
+
 	bool res = false;
 
-	for (auto cb : cbPoll) {
-		const Action &act = actionMap.at(cb.first);
-		if (act == event) {
-			cb.second();
+	for (Uint16 i = pollIndex[scancode]; i < pollIndex[scancode + 1]; ++i) {
+		const Binding &b = cbPoll[i];
+		if (b.action == event) {
+			b.callback();
 			res = true;
 		}
 	}
@@ -17,22 +57,92 @@ bool InputTarget<ActionKey>::processEvent(const SDL_Event& event) const {
 }
 
 template<typename ActionKey>
-void InputTarget<ActionKey>::processRealTimeEvents() const {
-	const Uint8 *kbState = SDL_GetKeyboardState(NULL);
+void InputTarget<ActionKey>::processRealTimeEvents() {
+	processRealTimeEvents(SDL_GetKeyboardState(NULL));
+}
 
-	for (auto cb : cbRealTime) {
-		if (actionMap.at(cb.first).test(kbState)) {
-			cb.second();
-		}
+template<typename ActionKey>
+void InputTarget<ActionKey>::processRealTimeEvents(const Uint8* kbState) {
+	uint32_t down = 0;
+	for (unsigned int a = 0; a < ActionState::MaxActions; ++a)
+		if (((bound >> a) & 1u) && kbState[actionKeys[a]])
+			down |= 1u << a;
+
+	// The keyboard state catches the changes of the threads and runs which do not see the events
+	const uint32_t pressed = pendingPressed | (down & ~state.down);
+	const uint32_t released = pendingReleased | (state.down & ~down);
+
+	const Uint32 now = SDL_GetTicks();
+	for (unsigned int a = 0; a < ActionState::MaxActions; ++a)
+		if (((pressed & ~pendingPressed) >> a) & 1u)
+			state.pressedAt[a] = now;
+
+	state.tick++;
+	state.down = down;
+	state.pressed = pressed;
+	state.released = released;
+	pendingPressed = pendingReleased = 0;
+
+	for (const Binding &b : cbRealTime)
+		if (b.action.test(kbState))
+			b.callback();
+}
+
+template<typename ActionKey>
+void InputTarget<ActionKey>::processActionState(const ActionState& recorded) {
+	const Uint32 now = SDL_GetTicks();
+	for (unsigned int a = 0; a < ActionState::MaxActions; ++a)
+		if ((recorded.pressed >> a) & 1u)
+			state.pressedAt[a] = now;
+
+	state.tick++;
+	state.down = recorded.down & bound;
+	state.pressed = recorded.pressed & bound;
+	state.released = recorded.released & bound;
+	pendingPressed = pendingReleased = 0;
+
+	// Same callbacks as the live input, an edge firing the poll bindings once
+	for (const Binding &b : cbPoll) {
+		const uint32_t bit = 1u << static_cast<unsigned int>(b.key);
+		if (((b.action.type & Action::Type::Pressed) && (state.pressed & bit)) || ((b.action.type & Action::Type::Released) && (state.released & bit)))
+			b.callback();
 	}
+
+	for (const Binding &b : cbRealTime)
+		if ((b.action.type & Action::Type::Pressed) && (state.down & (1u << static_cast<unsigned int>(b.key))))
+			b.callback();
 }
 
 template<typename ActionKey>
 void InputTarget<ActionKey>::bind(const ActionKey& key, const Action &a, const FuncCallback& callback) {
+	const unsigned int index = static_cast<unsigned int>(key);
+	if (index >= ActionState::MaxActions)
+		throw std::runtime_error("[Error] InputTarget::bind - action " + std::to_string(index) + " out of the action state");
+
+	if ((bound >> index) & 1u) {
+		std::cerr << "[Warning] InputTarget::bind - action " << index << " already bound" << std::endl;
+		return;
+	}
+
+	bound |= 1u << index;
+	actionKeys[index] = a.key;
+
 	if (a.type & Action::Type::RealTime)
-		cbRealTime.insert(std::make_pair(key, callback));
+		cbRealTime.push_back(Binding{ key, a, callback });
 	else
-		cbPoll.insert(std::make_pair(key, callback));
-	
-	actionMap.insert(std::make_pair(key, a));
-}
\ No newline at end of file
+		cbPoll.push_back(Binding{ key, a, callback });
+
+	compile();
+}
+
+// Binding is rare, the table is simply rebuilt
+template<typename ActionKey>
+void InputTarget<ActionKey>::compile() {
+	std::stable_sort(cbPoll.begin(), cbPoll.end(), [](const Binding& a, const Binding& b) { return a.action.key < b.action.key; });
+
+	pollIndex.fill(0);
+	for (const Binding &b : cbPoll)
+		pollIndex[b.action.key + 1]++;
+	for (size_t s = 1; s < pollIndex.size(); ++s)
+		pollIndex[s] += pollIndex[s - 1];
+}
@@ -3,25 +3,74 @@
 *
 *   This file designs the MCamera class for the game camera
 *
+*   Inside a room, the camera follows its target independently in X and Y, and stays still
+*   along an axis when the target is closer than half a screen to a wall of the room.
+*   Entering another room scrolls the view from one room to the other (2D Zelda style).
+*   The camera only holds a position, the renderer and the culling read its view rectangle.
+*
 ********************************************************************************************/
 
 #ifndef MECHA_CAMERA_HPP
 #define MECHA_CAMERA_HPP
 
-#include "MPhysac/MPhysacBody.hpp"
+#include <SDL.h>
+
+#include "Utils/Vector.hpp"
 
 class MCamera {
     public:
-        void update();
-        void setFollowedPhysicsBody(MPhysacBody* body);
-        //Camera2D& getCamera();
+        // Moves the view toward target, to be called once per rendered frame
+        void update(float dt, const Vector2f &target);
+
+        // The first room snaps the view, the next ones start a transition toward target in the new room
+        void setRoomBounds(const SDL_Rect &bounds, const Vector2f &target);
+        // The view is no longer clamped
+        void clearRoomBounds() { hasRoom = false; }
+
+        // Moves the view to center for an event, it stays there until follow() is called
+        void panTo(const Vector2f &center, float duration);
+        // Goes back to the target after a panTo()
+        void follow(float duration);
+
+        // The target moves this far from the center of the view before the camera follows (half extents)
+        void setDeadZone(const Vector2f &halfSize) { deadZone = halfSize; }
+        void setTransitionDuration(float seconds) { transitionDuration = seconds; }
+
+        // Visible area, in world coordinates
+        const SDL_Rect& getView() const { return view; }
+        const Vector2f& getCenter() const { return center; }
+        bool isVisible(const SDL_Rect &area) const { return SDL_HasIntersection(&area, &view); }
+        bool isTransitioning() const { return transition.active; }
 
-        MCamera();
+        MCamera(const Vector2f &viewSize);
 
     private:
-        //Camera2D camera;
-        MPhysacBody* cameraPhysicsBody;
-        MPhysacBody* followedPhysicsBody;
+        struct Transition {
+            bool active;
+            Vector2f from, to;
+            float elapsed, duration;
+        };
+
+        // Center of the view following target from the current center, inside the room
+        Vector2f followCenter(const Vector2f &target) const;
+        Vector2f clamp(const Vector2f &c) const;
+        void startTransition(const Vector2f &to, float duration);
+        void updateView();
+
+    private:
+        Vector2f size;
+        Vector2f center;
+        SDL_Rect view;
+
+        bool hasRoom;
+        SDL_Rect room;
+
+        Vector2f deadZone;
+        float transitionDuration;
+        Transition transition;
+
+        bool panned;            // Held by panTo() until follow()
+        bool returning;         // Transition of follow(), its end is recomputed as the target moves
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -137,7 +137,7 @@ extern "C" {
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
-#define PHYSAC_MAX_BODIES               128
+#define PHYSAC_MAX_BODIES               4096            // Size of the bodies pool, allocated once
 #define PHYSAC_MAX_MANIFOLDS            4096
 #define PHYSAC_MAX_VERTICES             24
 #define PHYSAC_CIRCLE_VERTICES          24
@@ -45,6 +45,7 @@ class MPhysacBody {
 
     private:
         friend class MPhysacWorld;
+        template<typename> friend class Pool;  // Bodies are constructed in the pool of the MPhysacWorld
         MPhysacBody(const Vector2f& pos, MPhysacShapeType type, const Vector2f& dim, float density);
         
 };
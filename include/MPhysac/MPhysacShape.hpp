@@ -9,6 +9,7 @@
 #define MPHYSAC_SHAPE_HPP
 
 #include "MPhysac.hpp"
+#include "Utils/FixedVector.hpp"
 
 class MPhysacBody;
 
@@ -17,8 +18,8 @@ class MPhysacBody;
 //---------------------------------------------------------------------------------
 class PolygonData {
     public:
-        std::vector<Vector2f> positions;     // Polygon vertex positions vectors
-        std::vector<Vector2f> normals;       // Polygon vertex normals vectors
+        FixedVector<Vector2f, PHYSAC_MAX_VERTICES> positions;     // Polygon vertex positions vectors
+        FixedVector<Vector2f, PHYSAC_MAX_VERTICES> normals;       // Polygon vertex normals vectors (inline, a body never allocates)
 
         void CreateRectanglePolygon(const Vector2f& pos, const Vector2f& size);
         void CreateRandomPolygon(float radius, int sides);
@@ -11,6 +11,8 @@
 #include <chrono>
 
 #include "MPhysacBody.hpp"
+#include "Utils/Metrics.hpp"
+#include "Utils/Pool.hpp"
 
 class MPhysacWorld {
     public:
@@ -28,18 +30,24 @@ class MPhysacWorld {
         void SetPhysicsTimeStep(const std::chrono::duration<float>& delta);                                                               // Sets physics fixed time step in milliseconds. 1.666666 by default
         bool IsPhysicsEnabled();                                                                            // Returns true if physics thread is currently enabled
         void SetPhysicsGravity(float x, float y);                                                               // Sets physics global gravity force
+        // The bodies come from a pool of PHYSAC_MAX_BODIES bodies : the creations return nullptr once it is full
         MPhysacBody* CreatePhysicsBodyCircle(const Vector2f& pos, float radius, float density);                 // Creates a new circle physics body with generic parameters
         MPhysacBody* CreatePhysicsBodyRectangle(const Vector2f& pos, float width, float height, float density); // Creates a new rectangle physics body with generic parameters
         MPhysacBody* CreatePhysicsBodyPolygon(const Vector2f& pos, float radius, int sides, float density);     // Creates a new polygon physics body with generic parameters
         size_t GetMPhysacBodiesCount();                                                                         // Returns the current amount of created physics bodies    
         size_t GetManifoldsCount();
+        unsigned int GetStepsCount();                                                                           // Steps run since the physics were initialized
+        unsigned long long GetPairsTestedCount();                                                               // Pairs tested for collision, over all the steps
+        unsigned long long GetManifoldsCreatedCount();                                                          // Pairs found in contact, over all the steps
+        unsigned long long GetSolverIterationsCount();                                                          // Impulses applied to the manifolds, over all the steps
+        size_t GetUsedMemory();                                                                                 // Bytes reserved by the bodies pool and the arrays
         MPhysacBody* GetMPhysacBody(int index);                                                                 // Returns a physics body of the bodies pool at a specific index
-        void DestroyMPhysacBody(MPhysacBody* body);                                                             // Unitializes and destroy a physics body
+        void DestroyMPhysacBody(MPhysacBody* body);                                                             // Unitializes and destroy a physics body, O(1)
         void ResetPhysics();                                                                                // Destroys created physics bodies and manifolds and resets global values
         void ClosePhysics();                                                                                // Unitializes physics pointers and closes physics loop thread
 
     private:
-        MPhysacWorld() {}                    // Constructor (the {} brackets) are needed here.
+        MPhysacWorld();
 
         //----------------------------------------------------------------------------------
         // Static Variables Definition
@@ -47,24 +55,33 @@ class MPhysacWorld {
         #ifndef PHYSAC_NO_THREADS
         pthread_t physicsThreadId;                           // Physics thread id
         #endif
-        unsigned int usedMemory = 0;                         // Total allocated dynamic memory
+        size_t usedMemory = 0;                               // Total allocated dynamic memory, updated after each step
         bool physicsThreadEnabled = false;                   // Physics thread enabled state
         std::chrono::duration<float> deltaTime = std::chrono::milliseconds(1);              // Delta time used for physics steps, in milliseconds
 
         std::chrono::duration<float> accumulator = std::chrono::duration<float>::zero();                            // Physics time step delta time accumulator
         unsigned int stepsCount = 0;                         // Total physics steps processed
+        unsigned long long pairsTestedCount = 0;             // Total pairs tested by the collision detection
+        unsigned long long manifoldsCreatedCount = 0;        // Total manifolds of the pairs in contact
+        unsigned long long solverIterationsCount = 0;        // Total impulses applied by the solver
         Vector2f gravityForce = { 0.0f, 9.81f };              // Physics world gravity force
+        Pool<MPhysacBody> bodyPool;                          // Storage of the bodies
         std::vector<MPhysacBody*> bodies;                    // Physics bodies pointers array
-        std::vector<PhysicsManifold*> contacts;               // Physics bodies pointers array
+        std::vector<uint32_t> bodyPositions;                 // Pool index of a body -> its position in bodies
+        std::vector<PhysicsManifold> contacts;                // Manifolds of the pairs in contact, cleared at each step but never freed
+
+        // Runtime metrics, published once per step
+        Metrics::Counter &stepsMetric, &pairsTestedMetric, &manifoldsCreatedMetric, &solverIterationsMetric;
+        Metrics::Gauge &bodiesMetric, &manifoldsMetric, &usedMemoryMetric;
+        Metrics::Histogram &stepDurationMetric;
 
         //----------------------------------------------------------------------------------
         // Private Functions Declaration
         //----------------------------------------------------------------------------------
-        int FindAvailableBodyIndex();                                                                        // Finds a valid index for a new physics body initialization
+        MPhysacBody* AddPhysicsBody(const Vector2f& pos, MPhysacShapeType type, const Vector2f& dim, float density);  // Takes a body from the pool and registers it
         void* PhysicsLoop(void* arg);                                                                        // Physics loop thread function
         void PhysicsStep();                                                                              // Physics steps calculations (dynamics, collisions and position corrections)
-        PhysicsManifold* CreatePhysicsManifold(MPhysacBody* a, MPhysacBody* b);                               // Creates a new physics manifold to solve collision
-        void DestroyPhysicsManifold(PhysicsManifold* manifold);                                               // Unitializes and destroys a physics manifold
+        void UpdateUsedMemory();                                                                             // Sums the memory reserved by the pool and the arrays
         void SolvePhysicsManifold(PhysicsManifold* manifold);                                                 // Solves a created physics manifold between two physics bodies
         void SolveCircleToCircle(PhysicsManifold* manifold);                                                  // Solves collision between two circle shape physics bodies
         void SolveCircleToPolygon(PhysicsManifold* manifold);                                                 // Solves collision between a circle to a polygon shape physics bodies
@@ -4,18 +4,64 @@
 #include <SDL.h>
 
 #include "Drawable.hpp"
+#include "ResourcesID.hpp"
 
 class Drawable;
+class TextureHandle;
+class ResourcesLoader;
+class RenderCaptureWriter;
+struct RenderState;
 struct SDL_Renderer;
 
 class Painter {
 	public:
-		Painter(SDL_Renderer *r) : renderer(r) {}
+		Painter(SDL_Renderer *r) : renderer(r), recording(nullptr), capture(nullptr), hasView(false), culled(0), drawCalls(0), lastTexture(nullptr), textureSwitches(0) {}
 
 		void draw(const Drawable& d) const { d.draw(*this); }
+
+		// World area on screen : the copies are moved by its position, those outside of it are skipped.
+		// Not applied while recording, the recorded states are in world coordinates until submitted.
+		void setView(const SDL_Rect& v) { view = v; hasView = true; }
+		void clearView() { hasView = false; }
+		// Copies skipped since the last call
+		unsigned int takeCulledCount() { unsigned int c = culled; culled = 0; return c; }
+		// Copies sent to the renderer since the last call
+		unsigned int takeDrawCallsCount() { unsigned int c = drawCalls; drawCalls = 0; return c; }
+		// Copies using another texture than the previous copy, since the last call : the batches a renderer could not merge
+		unsigned int takeTextureSwitchesCount() { unsigned int c = textureSwitches; textureSwitches = 0; return c; }
+
+		// Draws immediately, or appends to the recorded state
+		void copy(const TextureHandle& texture, const SDL_Rect& src, const SDL_Rect& dst) const;
+
+		// While set, nothing is drawn and the copies are recorded into state (no renderer needed)
+		void record(RenderState *state) { recording = state; }
+		// Draws a recorded state
+		void submit(const RenderState& state, ResourcesLoader& rl) const;
+
+		// While set, the copies sent to the renderer are also added to the capture, and the culled ones counted
+		void setCapture(RenderCaptureWriter *c) { capture = c; }
+
+		// Screen space drawing for the overlays : immediate, never recorded nor moved by the view
+		void fillRects(const SDL_Rect *rects, int count, const SDL_Color& color) const;
+		void fillRect(const SDL_Rect& rect, const SDL_Color& color) const { fillRects(&rect, 1, color); }
+		void copyScreen(SDL_Texture *texture, const SDL_Rect& src, const SDL_Rect& dst) const;
 		
 		SDL_Renderer *renderer;
 	private:
+		// Draws dst (world coordinates) through the view
+		void blit(Image::ID image, SDL_Texture *texture, const SDL_Rect& src, const SDL_Rect& dst) const;
+		void renderCopy(Image::ID image, SDL_Texture *texture, const SDL_Rect& src, const SDL_Rect& dst) const;
+
+	private:
+		RenderState *recording;
+		RenderCaptureWriter *capture;
+
+		bool hasView;
+		SDL_Rect view;
+		mutable unsigned int culled;
+		mutable unsigned int drawCalls;
+		mutable SDL_Texture *lastTexture;
+		mutable unsigned int textureSwitches;
 };
 
-#endif
\ No newline at end of file
+#endif
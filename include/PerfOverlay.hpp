@@ -0,0 +1,79 @@
+#ifndef MECHA_PERFOVERLAY_HPP
+#define MECHA_PERFOVERLAY_HPP
+
+#include <array>
+#include <atomic>
+
+#include <SDL.h>
+
+class Painter;
+
+/**
+ * Performance overlay drawn over the game : a rolling graph of the last frame times, their percentiles,
+ * the per phase timings and the engine counters, written with a built-in bitmap font.
+ * Everything is kept in fixed size buffers, drawing it does not allocate.
+ * The phases and the simulation counters may be reported by the simulation thread, the rest belongs to the rendering thread.
+ */
+class PerfOverlay {
+	public:
+		enum Phase {
+			Update,
+			Physics,
+			Render,
+			PhasesCount
+		};
+
+		enum : unsigned int {
+			HistorySize = 240,      // Frames in the graph
+			MaxLines = 6,           // Free lines set by the game
+			LineLength = 64
+		};
+
+	public:
+		PerfOverlay();
+		~PerfOverlay();
+
+		PerfOverlay(const PerfOverlay&) = delete;
+		PerfOverlay& operator=(const PerfOverlay&) = delete;
+
+		// Creates the font texture, nothing is drawn without it
+		void init(SDL_Renderer *renderer);
+
+		void setVisible(bool v) { visible = v; }
+		void toggle() { visible = !visible; }
+		bool isVisible() const { return visible; }
+
+		// Duration of a rendered frame, in milliseconds
+		void addFrame(float ms);
+		// Duration of a phase, in milliseconds, smoothed over the last frames
+		void addPhase(Phase phase, float ms);
+
+		void setSimulationCounters(unsigned int bodies, unsigned int manifolds) { this->bodies = bodies; this->manifolds = manifolds; }
+		void setRenderCounters(unsigned int drawCalls, size_t textureBytes) { this->drawCalls = drawCalls; this->textureBytes = textureBytes; }
+
+		// printf like, the text is cut at LineLength characters
+		void setLine(unsigned int line, const char *format, ...);
+
+		void draw(const Painter &painter) const;
+
+	private:
+		// Draws text in screen coordinates, returns the height of a line
+		int drawText(const Painter &painter, int x, int y, const char *text) const;
+
+	private:
+		SDL_Texture *font;
+		bool visible;
+
+		std::array<float, HistorySize> frames;
+		unsigned int frameIndex, framesCount;
+
+		std::atomic<float> phases[PhasesCount];
+		std::atomic<unsigned int> bodies, manifolds;
+		unsigned int drawCalls;
+		size_t textureBytes;
+
+		char lines[MaxLines][LineLength];
+		mutable float drawDuration;     // Of the last draw, shown by the next one
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef MECHA_RENDERCAPTURE_HPP
+#define MECHA_RENDERCAPTURE_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include <SDL.h>
+
+#include "ResourcesID.hpp"
+
+/**
+ * Binary capture of the copies the Painter sends to the renderer, frame by frame, replayed offline by mecha_replay.
+ *
+ * Layout (little endian) :
+ * - Header
+ * - For each frame : FrameHeader, then FrameHeader::commandsCount Command
+ * The structs are written raw, so their layout is the format : it is checked at compile time, with the byte order of the host.
+ * The commands are in the drawing order and in screen coordinates (the view already applied), the culled copies are only counted.
+ */
+
+namespace Capture {
+	const uint32_t Magic = 0x4352564D; // "MVRC"
+	const uint32_t Version = 1;
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t screenWidth, screenHeight;
+	};
+
+	struct FrameHeader {
+		uint64_t frame;             // Rendered frame since the capture started
+		uint32_t commandsCount;
+		uint32_t culledCount;       // Copies skipped by the view
+	};
+
+	struct Command {
+		uint32_t image;             // Image::ID
+		SDL_Rect src;
+		SDL_Rect dst;
+	};
+
+	static_assert(SDL_BYTEORDER == SDL_LIL_ENDIAN, "Render captures are written in the byte order of the host, which must be little endian");
+	static_assert(sizeof(Header) == 16, "Capture::Header does not match the file format");
+	static_assert(sizeof(FrameHeader) == 16 && offsetof(FrameHeader, commandsCount) == 8, "Capture::FrameHeader does not match the file format");
+	static_assert(sizeof(SDL_Rect) == 16 && offsetof(SDL_Rect, y) == 4 && offsetof(SDL_Rect, w) == 8 && offsetof(SDL_Rect, h) == 12,
+		"SDL_Rect is not four 32 bits integers x, y, w, h");
+	static_assert(sizeof(Command) == 36 && offsetof(Command, src) == 4 && offsetof(Command, dst) == 20, "Capture::Command does not match the file format");
+}
+
+class RenderCaptureWriter {
+	public:
+		// Throws if the file cannot be created
+		RenderCaptureWriter(const std::string& filename, int screenWidth, int screenHeight);
+
+		RenderCaptureWriter(const RenderCaptureWriter&) = delete;
+		RenderCaptureWriter& operator=(const RenderCaptureWriter&) = delete;
+
+		// Called by the Painter
+		void add(Image::ID image, const SDL_Rect& src, const SDL_Rect& dst) { commands.push_back(Capture::Command{ (uint32_t)image, src, dst }); }
+		void addCulled() { culled++; }
+
+		// Writes the commands added since the previous frame
+		void endFrame();
+
+		unsigned long long getFramesCount() const { return frame; }
+
+	private:
+		std::ofstream file;
+		std::vector<Capture::Command> commands;
+		uint32_t culled;
+		unsigned long long frame;
+};
+
+class RenderCaptureReader {
+	public:
+		struct Frame {
+			uint64_t frame;
+			uint32_t culledCount;
+			std::vector<Capture::Command> commands;
+		};
+
+	public:
+		// Throws if the file cannot be read or is not a render capture. The frames are read one at a time.
+		explicit RenderCaptureReader(const std::string& filename);
+
+		int getScreenWidth() const { return (int)header.screenWidth; }
+		int getScreenHeight() const { return (int)header.screenHeight; }
+
+		// Reads the next frame, returns false at the end of the capture. Throws if it is truncated.
+		bool next(Frame& frame);
+
+	private:
+		std::string filename;
+		std::ifstream file;
+		Capture::Header header;
+};
+
+#endif
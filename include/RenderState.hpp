@@ -0,0 +1,33 @@
+#ifndef MECHA_RENDERSTATE_HPP
+#define MECHA_RENDERSTATE_HPP
+
+#include <vector>
+
+#include <SDL.h>
+
+#include "ResourcesID.hpp"
+#include "Utils/Vector.hpp"
+
+// One textured quad
+struct RenderCommand {
+	Image::ID image;
+	SDL_Rect src;
+	SDL_Rect dst;
+};
+
+/**
+ * Everything needed to draw one simulation tick, recorded by the simulation thread and drawn by the main thread.
+ * Only holds values : the entities may change while it is drawn.
+ */
+struct RenderState {
+	RenderState() : tick(0) {}
+
+	// Keeps the capacity, a recycled state does not allocate
+	void clear() { commands.clear(); }
+
+	unsigned long long tick;
+	Vector2f playerPosition;        // Drives the room streaming, done by the main thread
+	std::vector<RenderCommand> commands;
+};
+
+#endif
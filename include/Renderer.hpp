@@ -6,7 +6,8 @@ struct SDL_Renderer;
 
 class Renderer {
 	public:
-		Renderer(const Window &win);
+		// With vsync, SDL_RenderPresent waits for the vertical blank
+		Renderer(const Window &win, bool vsync = false);
 		~Renderer();
 
 		SDL_Renderer *r;
@@ -1,10 +1,32 @@
 #ifndef MECHA_RESOURCESID_HPP
 #define MECHA_RESOURCESID_HPP
 
+#include <string>
+
 namespace Image {
 	enum ID {
 		Player,
+
+		Count // Number of images, must stay last
+	};
+
+	// Source file of an image, relative to the assets directory
+	const char* fileName(ID id);
+}
+
+namespace Animation {
+	enum ID {
+		Player,
+
+		Count // Number of animation clips, must stay last
 	};
 }
 
-#endif
\ No newline at end of file
+namespace Room {
+	typedef unsigned int ID;
+
+	// Description file of a room, see RoomData
+	std::string fileName(ID id);
+}
+
+#endif
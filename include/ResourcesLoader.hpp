@@ -2,33 +2,144 @@
 #define MECHA_RESOURCESLOADER_HPP
 
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
+#include <chrono>
 
 #include <SDL.h>
 #include <SDL2/SDL_image.h>
 
 #include "ResourcesID.hpp"
+#include "ResourcesPack.hpp"
+#include "ResourcesPrefetcher.hpp"
+#include "TextureHandle.hpp"
+#include "World/RoomData.hpp"
+#include "Utils/FileWatcher.hpp"
+#include "Utils/Vector.hpp"
 
 class ResourcesLoader {
 	public:
-		ResourcesLoader(SDL_Renderer* renderer);
+		struct PrefetchStats {
+			unsigned int requests;      // Rooms queued for background loading
+			unsigned int hits;          // Rooms and images already available when entering a room
+			unsigned int misses;        // Rooms and images loaded synchronously when entering a room
+		};
+
+	public:
+		// Textures are taken from the pack when it exists, from the loose image files otherwise.
+		// Without a renderer (headless), only the rooms and the sprites frames are loaded.
+		ResourcesLoader(SDL_Renderer* renderer, const std::string& packFile = "assets.mvpk", const std::string& spritesFile = "sprites.txt");
 		virtual ~ResourcesLoader(); // unload all resources
 
 		void load(Image::ID id);
-		// void unload(Image::ID id); No unload for the moment
+		void unload(Image::ID id); // Only unloaded if no TextureHandle references it
 
 		SDL_Texture* get(Image::ID id);
 		const SDL_Texture* get(Image::ID id) const;
+		// Like TextureHandle::get : reloads the texture if it was evicted
+		SDL_Texture* use(Image::ID id) { return use(&slotOf(id)); }
+
+		// Frames of the sprites of an image. The sprites definition file has priority, then the first definition wins.
+		// The reference stays valid for the loader lifetime, the hot reload updates the frames in place.
+		const std::vector<SDL_Rect>& defineFrames(Image::ID id, const std::vector<SDL_Rect>& rects);
+		const std::vector<SDL_Rect>& getFrames(Image::ID id) const { return frames[id]; }
+		// Incremented each time some frames change
+		unsigned int getFramesVersion() const { return framesVersion; }
+
+		// One line per image : frames <Image::ID> <x> <y> <w> <h> [<x> <y> <w> <h> ...]
+		// Returns false if the file does not exist, throws if it is malformed
+		bool loadSpritesDefinitions(const std::string& filename);
+
+		// Modified image files and sprites definitions are reloaded in place by update(), the images being decoded in the background
+		void setHotReload(bool enabled);
+
+		// Residency : images of the current and adjacent rooms are kept, the others are evicted (least recently used first)
+		// as soon as the used memory goes over the budget
+		void setRoomImages(Room::ID room, const std::vector<Image::ID>& images);
+		void setResidentRooms(Room::ID current, const std::vector<Room::ID>& adjacent);
+
+		// Rooms : the entered room is loaded synchronously (unless prefetched, a pending prefetch is waited for), the rooms behind its doors become resident
+		const RoomData& enterRoom(Room::ID room);
+		const RoomData* getCurrentRoom() const { return currentRoom; }
+		// The current room or a prefetched one, nullptr if it is not loaded yet
+		const RoomData* findRoom(Room::ID room) const;
+
+		// Background loading of the description and images of a room
+		void prefetchRoom(Room::ID room);
+		// Prefetches the rooms behind the doors of the current room closer than lookahead to position
+		void prefetchNear(const Vector2f& position, float lookahead);
+		const PrefetchStats& getPrefetchStats() const { return prefetchStats; }
+
+		// Uploads the prefetched images, at most maxUploads per call so that a frame never pays for a whole room
+		void update(unsigned int maxUploads = 1);
+
+		void setMemoryBudget(size_t bytes) { memoryBudget = bytes; trim(); }
+		size_t getMemoryBudget() const { return memoryBudget; }
+		size_t getUsedBytes() const { return usedBytes; }
+		unsigned int getEvictionsCount() const { return evictions; }
+
+		// To be called once per rendered frame, drives the LRU ordering
+		void nextFrame() { frame++; }
+
+		// Loading statistics, to compare the pack against the loose files
+		const std::chrono::duration<float>& getLoadDuration() const { return loadDuration; }
+		unsigned int getPackLoadsCount() const { return packLoads; }
+		unsigned int getFileLoadsCount() const { return fileLoads; }
+
+	private:
+		friend class TextureHandle;
+
+		TextureSlot* acquire(Image::ID id);
+		void release(TextureSlot *slot);
+		SDL_Texture* use(TextureSlot *slot);
+
+		TextureSlot& slotOf(Image::ID id) { return slots[owners[id]]; }
+		const TextureSlot& slotOf(Image::ID id) const { return slots[owners[id]]; }
+
+		SDL_Texture* loadFromPack(Image::ID id);
+		SDL_Texture* loadFromSurface(Image::ID id);
+		void collectPrefetched();
+		void hotReload();
+		void evict(TextureSlot &slot);
+		void trim();
 
 	private:
 		SDL_Renderer *renderer;
+		ResourcesPack pack;
+
+		std::chrono::duration<float> loadDuration;
+		unsigned int packLoads, fileLoads;
 
-		// Loaded textures list
-		std::map<Image::ID, SDL_Texture*> texturesMap;
+		// One slot per Image::ID, never reallocated so that TextureHandle can point to them
+		std::vector<TextureSlot> slots;
+		// Image whose slot holds the texture of each image (itself, or the image it corresponds to)
+		std::vector<Image::ID> owners;
+
+		// Sprites frames, one entry per Image::ID, never reallocated
+		std::vector<std::vector<SDL_Rect>> frames;
+		unsigned int framesVersion;
+		std::string spritesFile;
+		std::unique_ptr<FileWatcher> watcher;
 
-		std::map<Image::ID, const std::string> imgFileMap;
 		std::map<Image::ID, const std::vector<Image::ID>> correspondingImgMap;
+		std::map<Room::ID, std::vector<Image::ID>> roomImagesMap;
+		std::vector<Room::ID> residentRooms;
+
+		// Descriptions of the current room and of the prefetched ones
+		std::map<Room::ID, RoomData> rooms;
+		const RoomData *currentRoom;
+
+		// Images decoded by the prefetcher, waiting for their upload
+		std::map<Image::ID, SDL_Surface*> prefetchedSurfaces;
+		PrefetchStats prefetchStats;
+
+		size_t memoryBudget;
+		size_t usedBytes;
+		unsigned int evictions;
+		unsigned long long frame;
+
+		ResourcesPrefetcher prefetcher; // Last, its worker thread must stop before anything else is destroyed
 };
 
-#endif
\ No newline at end of file
+#endif
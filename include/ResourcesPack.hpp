@@ -0,0 +1,101 @@
+#ifndef MECHA_RESOURCESPACK_HPP
+#define MECHA_RESOURCESPACK_HPP
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ResourcesID.hpp"
+
+/**
+ * Asset pack file, built offline by mecha_pack and memory-mapped at runtime.
+ *
+ * Layout (little endian) :
+ * - Header
+ * - Index : open addressing hash table of Header::indexSize IndexEntry slots, keyed by Image::ID
+ * - Payload : pre-decoded pixel blocks, each one 16 bytes aligned
+ */
+
+namespace Pack {
+	const uint32_t Magic = 0x4B50564D; // "MVPK"
+	const uint32_t Version = 1;
+	const uint32_t EmptySlot = 0xFFFFFFFF;
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;        // Number of assets in the pack
+		uint32_t indexSize;         // Number of index slots, power of 2
+		uint64_t indexOffset;       // Offset of the first index slot from the beginning of the file
+	};
+
+	struct IndexEntry {
+		uint32_t id;                // Image::ID, or EmptySlot
+		uint32_t format;            // SDL pixel format
+		uint32_t width, height;
+		uint32_t pitch;             // Bytes per row
+		uint32_t reserved;
+		uint64_t offset;            // Offset of the pixels from the beginning of the file
+		uint64_t size;              // Size of the pixels block
+	};
+
+	inline uint32_t hashID(uint32_t id) { return id * 2654435761u; }
+}
+
+class ResourcesPack {
+	public:
+		struct Entry {
+			uint32_t format;
+			int width, height;
+			int pitch;
+			const void *pixels;
+		};
+
+	public:
+		ResourcesPack();
+		~ResourcesPack();
+
+		ResourcesPack(const ResourcesPack&) = delete;
+		ResourcesPack& operator=(const ResourcesPack&) = delete;
+
+		// Returns false if the file does not exist, throws if it is not a valid pack
+		bool open(const std::string& filename);
+		void close();
+
+		bool isOpen() const { return data != nullptr; }
+
+		// Pointer lookup only, the pixels stay in the mapping
+		bool find(Image::ID id, Entry& entry) const;
+
+	private:
+		const Pack::IndexEntry* findSlot(uint32_t id) const;
+
+	private:
+		const unsigned char *data;
+		size_t size;
+
+		const Pack::Header *header;
+		const Pack::IndexEntry *index;
+
+#ifdef _WIN32
+		void *fileHandle;
+		void *mappingHandle;
+#endif
+};
+
+// Offline side, used by the packer tool
+class ResourcesPackWriter {
+	public:
+		void add(Image::ID id, uint32_t format, int width, int height, int pitch, const void *pixels);
+		void write(const std::string& filename) const;
+
+	private:
+		struct Asset {
+			Pack::IndexEntry entry;
+			std::vector<unsigned char> pixels;
+		};
+
+		std::vector<Asset> assets;
+};
+
+#endif
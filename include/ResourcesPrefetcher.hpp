@@ -0,0 +1,72 @@
+#ifndef MECHA_RESOURCESPREFETCHER_HPP
+#define MECHA_RESOURCESPREFETCHER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ResourcesID.hpp"
+#include "World/RoomData.hpp"
+
+struct SDL_Surface;
+class ResourcesPack;
+
+/**
+ * Background loading of rooms and images : reads the room description and decodes the images on a worker thread.
+ * Textures can only be created on the rendering thread, so ResourcesLoader uploads the results itself.
+ */
+class ResourcesPrefetcher {
+	public:
+		struct Result {
+			RoomData room;
+			bool valid;                                                 // false if the room file does not exist
+			std::vector<std::pair<Image::ID, SDL_Surface*>> surfaces;   // Decoded loose images, owned by the receiver
+		};
+
+	public:
+		ResourcesPrefetcher(const ResourcesPack &pack);
+		~ResourcesPrefetcher();
+
+		ResourcesPrefetcher(const ResourcesPrefetcher&) = delete;
+		ResourcesPrefetcher& operator=(const ResourcesPrefetcher&) = delete;
+
+		// Ignored if the room is already queued or being loaded
+		void request(Room::ID room);
+		bool isPending(Room::ID room) const;
+		// Blocks until the pending room is finished, it is then collected as the others
+		void wait(Room::ID room);
+
+		// Decodes a single loose image file (the pack is ignored), used to reload a modified image
+		void requestImage(Image::ID img);
+
+		// Moves the finished rooms into results
+		void collect(std::vector<Result>& results);
+		// Moves the decoded single images into images, nullptr if the decoding failed
+		void collectImages(std::vector<std::pair<Image::ID, SDL_Surface*>>& images);
+
+	private:
+		void run();
+		Result prefetch(Room::ID room) const;
+
+	private:
+		const ResourcesPack &pack;
+
+		mutable std::mutex mutex;
+		std::condition_variable wakeUp;
+		std::condition_variable finished;   // A room was added to done
+		std::deque<Room::ID> queue;
+		std::set<Room::ID> pending;     // Queued or being loaded
+		std::vector<Result> done;
+
+		std::deque<Image::ID> imagesQueue;
+		std::vector<std::pair<Image::ID, SDL_Surface*>> imagesDone;
+		bool stopping;
+
+		std::thread worker;             // Last, so that it starts once everything else is built
+};
+
+#endif
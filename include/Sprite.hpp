@@ -1,11 +1,12 @@
 #ifndef MECHA_SPRITE_HPP
 #define MECHA_SPRITE_HPP
 
-#include <map>
+#include <vector>
 
 #include "Utils/Vector.hpp"
 #include "Drawable.hpp"
 #include "ResourcesID.hpp"
+#include "TextureHandle.hpp"
 
 class Painter;
 struct SDL_Rect;
@@ -13,9 +14,6 @@ struct SDL_Texture;
 class ResourcesLoader;
 
 class Sprite : public Drawable {
-	private:
-		static std::map<Image::ID, SDL_Rect> srcRect;
-
 	public:
 		Sprite(ResourcesLoader &rl, Image::ID id, int srcX, int srcY, int srcW, int srcH);
 		Sprite(ResourcesLoader &rl, Image::ID id, const Vector2i& pos, const Vector2i& size) : Sprite(rl, id, pos.x, pos.y, size.x, size.y) {}
@@ -29,7 +27,8 @@ class Sprite : public Drawable {
 
 	private:
 		SDL_Rect dstRect;
-		ResourcesLoader &resources;
+		TextureHandle texture;
+		const std::vector<SDL_Rect> &frames; // Owned by the ResourcesLoader, only the first one is drawn
 		Image::ID imgID;
 	
 	private:
@@ -0,0 +1,53 @@
+#ifndef MECHA_TEXTUREHANDLE_HPP
+#define MECHA_TEXTUREHANDLE_HPP
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "ResourcesID.hpp"
+
+struct SDL_Texture;
+class ResourcesLoader;
+
+// Residency information of one texture, owned by ResourcesLoader
+struct TextureSlot {
+	SDL_Texture *texture;           // nullptr while not loaded or evicted
+	Image::ID id;
+	size_t bytes;                   // Memory used by the texture once loaded
+	// Live TextureHandle on this slot, never evicted while > 0. Atomic : the simulation thread copies and destroys the handles
+	// of the sprites while the main thread acquires, releases and trims. Only acquire, on the main thread, takes it from 0.
+	std::atomic<unsigned int> refCount;
+	unsigned long long lastUse;     // Loader frame of the last access, for LRU eviction
+	bool resident;                  // Used by the current room or an adjacent one
+};
+
+/**
+ * Reference counted access to a texture.
+ * The slot address is stable for the loader lifetime, the texture it holds may be evicted and reloaded.
+ */
+class TextureHandle {
+	public:
+		TextureHandle() : loader(nullptr), slot(nullptr) {}
+		TextureHandle(ResourcesLoader &rl, Image::ID id);
+		TextureHandle(const TextureHandle& other);
+		TextureHandle(TextureHandle&& other);
+		~TextureHandle();
+
+		TextureHandle& operator=(TextureHandle other);
+
+		// Reloads the texture if it was evicted
+		SDL_Texture* get() const;
+
+		Image::ID getID() const { return slot->id; }
+		bool isValid() const { return slot != nullptr; }
+
+	private:
+		void release();
+
+	private:
+		ResourcesLoader *loader;
+		TextureSlot *slot;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef MECHA_ALLOCTRACKER_HPP
+#define MECHA_ALLOCTRACKER_HPP
+
+/**
+ * Heap allocation tracker of the debug builds : operator new and delete are replaced to count the allocations and bytes
+ * of each subsystem, the live bytes and their peak.
+ * The code marked as hot path must not allocate once the game reached its steady state, such allocations are recorded to be reported.
+ * Only built with the MECHA_ALLOC_TRACKER definition (debug builds), the macros compile to nothing otherwise :
+ *   MECHA_ALLOC_TAG(Tag)             Attributes the allocations of the enclosing scope to AllocTracker::Tag
+ *   MECHA_ALLOC_HOT_PATH("name")     Marks the enclosing scope as a hot path, the name must be a string literal
+ *   MECHA_ALLOC_STEADY()             Ends the warm up, from now on the hot paths must not allocate
+ */
+
+#ifdef MECHA_ALLOC_TRACKER
+
+#include <ostream>
+
+#include <stddef.h>
+#include <stdint.h>
+
+class AllocTracker {
+	public:
+		enum Tag {
+			Untagged,
+			Physics,
+			Render,
+			Resources,
+			Input,
+			Gameplay,
+			TagsCount
+		};
+
+		struct Stats {
+			uint64_t allocations[TagsCount];
+			uint64_t bytes[TagsCount];
+			uint64_t liveBytes;
+			uint64_t peakLiveBytes;
+			uint64_t hotPathAllocations;    // Since the steady state was reached
+		};
+
+		class Scope {
+			public:
+				explicit Scope(Tag tag);
+				~Scope();
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+
+			private:
+				Tag previous;
+		};
+
+		class HotPath {
+			public:
+				explicit HotPath(const char *name);
+				~HotPath();
+
+				HotPath(const HotPath&) = delete;
+				HotPath& operator=(const HotPath&) = delete;
+
+			private:
+				const char *previous;
+		};
+
+	public:
+		// Allocations and bytes since the last call, the live bytes and the peak since the start
+		static Stats takeStats();
+		static uint64_t getHotPathAllocations();
+
+		static void setSteadyState();
+
+		// Hot path, tag and size of the first allocations caught on a hot path
+		static void reportHotPathAllocations(std::ostream &out);
+
+		static const char* tagName(Tag tag);
+
+		// Called by the replaced operators
+		static void* allocate(size_t size, bool nothrow);
+		static void release(void *p);
+};
+
+#define MECHA_ALLOC_CONCAT_(a, b) a##b
+#define MECHA_ALLOC_CONCAT(a, b) MECHA_ALLOC_CONCAT_(a, b)
+
+#define MECHA_ALLOC_TAG(tag) AllocTracker::Scope MECHA_ALLOC_CONCAT(allocTag, __LINE__)(AllocTracker::tag)
+#define MECHA_ALLOC_HOT_PATH(name) AllocTracker::HotPath MECHA_ALLOC_CONCAT(allocHotPath, __LINE__)(name)
+#define MECHA_ALLOC_STEADY() AllocTracker::setSteadyState()
+
+#else
+
+// Still statements, so that "if (...) MECHA_ALLOC_STEADY();" does not leave an empty body
+#define MECHA_ALLOC_TAG(tag) ((void)0)
+#define MECHA_ALLOC_HOT_PATH(name) ((void)0)
+#define MECHA_ALLOC_STEADY() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef MECHA_FILEWATCHER_HPP
+#define MECHA_FILEWATCHER_HPP
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+/**
+ * Reports the modification of a set of files, without blocking.
+ * Uses inotify on Linux (the directories are watched, so that files replaced by a rename are seen too),
+ * and compares the modification times twice per second elsewhere.
+ */
+class FileWatcher {
+	public:
+		FileWatcher();
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		void watch(const std::string& filename);
+
+		// Appends the files modified since the last call, each one only once
+		void poll(std::vector<std::string>& modified);
+
+	private:
+#ifdef __linux__
+		int fd;
+		std::map<int, std::string> directories;     // inotify watch descriptor -> directory
+		std::set<std::string> files;
+#else
+		std::map<std::string, time_t> files;        // File -> last modification time
+		std::chrono::steady_clock::time_point lastPoll;
+#endif
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MECHA_FIXEDVECTOR_HPP
+#define MECHA_FIXEDVECTOR_HPP
+
+#include <cassert>
+#include <stddef.h>
+
+/**
+ * Vector with an inline storage of N elements : never allocates, and copying it is a plain copy.
+ */
+template<typename T, size_t N>
+class FixedVector {
+	public:
+		FixedVector() : count(0) {}
+
+		void push_back(const T& value) { assert(count < N); items[count++] = value; }
+		void clear() { count = 0; }
+
+		size_t size() const { return count; }
+		bool empty() const { return count == 0; }
+		static size_t capacity() { return N; }
+
+		T& operator[](size_t i) { assert(i < count); return items[i]; }
+		const T& operator[](size_t i) const { assert(i < count); return items[i]; }
+
+		T* begin() { return items; }
+		T* end() { return items + count; }
+		const T* begin() const { return items; }
+		const T* end() const { return items + count; }
+
+	private:
+		T items[N];
+		size_t count;
+};
+
+#endif
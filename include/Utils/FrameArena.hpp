@@ -0,0 +1,91 @@
+#ifndef MECHA_FRAMEARENA_HPP
+#define MECHA_FRAMEARENA_HPP
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * Bump allocator for the scratch data of one frame : allocating is a pointer increment, and everything is freed at once by reset().
+ * Each thread binds its own arena, the game loops reset it at the top of each iteration.
+ * What does not fit is allocated on the heap instead, and the arena grows at the next reset so that the following frames fit.
+ */
+class FrameArena {
+	public:
+		explicit FrameArena(size_t capacity = 256 * 1024);
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		// nullptr if the arena is full
+		void* allocate(size_t bytes, size_t alignment);
+		bool owns(const void* p) const { return p >= buffer && p < buffer + capacity; }
+
+		// Frees everything allocated since the last reset : nothing allocated from the arena may outlive the frame
+		void reset();
+
+		size_t getCapacity() const { return capacity; }
+		size_t getUsed() const { return used; }
+
+		// Largest frame since the last call, in bytes, the allocations which did not fit included. Can be called from any thread.
+		size_t takePeak() { return peak.exchange(0); }
+		// Allocations which did not fit since the last call
+		unsigned int takeOverflows() { return overflows.exchange(0); }
+
+		// Arena of the calling thread, nullptr if none is bound
+		static FrameArena* current();
+		static void bind(FrameArena* arena);
+
+	private:
+		unsigned char *buffer;
+		size_t capacity;
+		size_t used;
+		size_t demand;                          // Bytes requested during the frame, those which did not fit included
+
+		std::atomic<size_t> peak;
+		std::atomic<unsigned int> overflows;
+};
+
+/**
+ * STL allocator on the arena of the thread which built it, or on the heap if the thread has none.
+ */
+template<typename T>
+class ArenaAllocator {
+	public:
+		typedef T value_type;
+
+		ArenaAllocator() : arena(FrameArena::current()) {}
+		explicit ArenaAllocator(FrameArena *arena) : arena(arena) {}
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+		T* allocate(size_t n) {
+			void *p = arena ? arena->allocate(n * sizeof(T), alignof(T)) : nullptr;
+			if (!p)
+				p = ::operator new(n * sizeof(T));
+
+			return static_cast<T*>(p);
+		}
+
+		// Nothing to do for the arena memory, it is freed by the reset
+		void deallocate(T* p, size_t) {
+			if (!arena || !arena->owns(p))
+				::operator delete(p);
+		}
+
+		template<typename U>
+		bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+		template<typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+		FrameArena *arena;
+};
+
+// Scratch vector, to be dropped before the end of the frame
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
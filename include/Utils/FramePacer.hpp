@@ -0,0 +1,62 @@
+#ifndef MECHA_FRAMEPACER_HPP
+#define MECHA_FRAMEPACER_HPP
+
+#include <chrono>
+#include <string>
+
+/**
+ * Waits for the next deadline of the game loop without keeping a core busy.
+ * The thread sleeps until a short margin before the deadline, then spins the remaining time,
+ * the OS timers alone waking up too late to keep a steady frame time.
+ * The lateness of each wake up is measured, it is the jitter added by the pacing.
+ */
+class FramePacer {
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		enum Mode {
+			Spin,       // Busy waits until the deadline (lowest jitter, one core at 100%)
+			Sleep,      // Sleeps, then spins during the margin
+			VSync,      // SDL_RenderPresent waits for the vertical blank, the pacer only waits when nothing is rendered
+			PowerSave   // Sleeps without spinning, and the game renders at the update rate
+		};
+
+		struct JitterStats {
+			unsigned int waits;
+			float meanLateness;         // Microseconds
+			float maxLateness;          // Microseconds
+			float sleepRatio;           // Part of the measured period spent sleeping
+		};
+
+	public:
+		FramePacer(Mode mode = Sleep);
+		~FramePacer();
+
+		FramePacer(const FramePacer&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+
+		void setMode(Mode newMode) { mode = newMode; }
+		Mode getMode() const { return mode; }
+
+		// Time spun before each deadline, should be above the timer resolution of the OS
+		void setSpinMargin(const std::chrono::microseconds& margin) { spinMargin = margin; }
+
+		// Returns immediately if the deadline is already over
+		void waitUntil(const Clock::time_point& deadline);
+
+		// Statistics since the last call
+		JitterStats takeStats();
+
+		// Parses "spin", "sleep", "vsync" or "powersave", throws otherwise
+		static Mode modeFromName(const std::string& name);
+
+	private:
+		Mode mode;
+		std::chrono::microseconds spinMargin;
+
+		unsigned int waits;
+		Clock::duration totalLateness, maxLateness, sleeping;
+		Clock::time_point statsStart;
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef MECHA_METRICS_HPP
+#define MECHA_METRICS_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * Runtime metrics of the engine, registered by name and written as snapshots to a file for the analysis of long soak runs.
+ *   Counter   : events since the start, each thread incrementing its own slot so that the threads never contend
+ *   Gauge     : last value set (bodies alive, bytes resident...)
+ *   Histogram : distribution of a duration in microseconds, in log-linear buckets of 16 steps per power of two (about 6% precision)
+ * Registering takes a lock and is meant for the initialization, the returned references stay valid until the end of the program.
+ * Updating a metric never locks nor allocates.
+ */
+class Metrics {
+	public:
+		class Counter {
+			public:
+				enum : unsigned int { Slots = 8 };
+
+				Counter();
+
+				void add(uint64_t n = 1) { slots[threadSlot()].value.fetch_add(n, std::memory_order_relaxed); }
+				uint64_t value() const;
+
+			private:
+				// A cache line each, the threads writing to different slots do not share lines
+				struct Slot {
+					std::atomic<uint64_t> value;
+					char padding[64 - sizeof(std::atomic<uint64_t>)];
+				};
+
+				Slot slots[Slots];
+		};
+
+		class Gauge {
+			public:
+				Gauge() : current(0) {}
+
+				void set(int64_t v) { current.store(v, std::memory_order_relaxed); }
+				void add(int64_t v) { current.fetch_add(v, std::memory_order_relaxed); }
+				int64_t value() const { return current.load(std::memory_order_relaxed); }
+
+			private:
+				std::atomic<int64_t> current;
+		};
+
+		class Histogram {
+			public:
+				enum : unsigned int {
+					SubBuckets = 16,
+					Buckets = SubBuckets * 29      // Exact up to 15, then 16 buckets per power of two up to 2^32
+				};
+
+				// Recorded since the last snapshot
+				struct Summary {
+					uint64_t count;
+					uint64_t max;
+					double mean;
+					uint64_t p50, p90, p99;
+				};
+
+			public:
+				Histogram();
+
+				void record(uint64_t value);
+
+				// Summary of the values recorded since the last call, the histogram restarts empty
+				Summary take();
+
+				// Lowest value of a bucket
+				static uint64_t bucketValue(unsigned int bucket);
+				static unsigned int bucketOf(uint64_t value);
+
+			private:
+				std::atomic<uint64_t> counts[Buckets];
+				std::atomic<uint64_t> total, sum, max;
+		};
+
+	public:
+		// Returns the metric of this name, created on the first call. Throws if the name is registered with another type.
+		static Counter& counter(const std::string& name);
+		static Gauge& gauge(const std::string& name);
+		static Histogram& histogram(const std::string& name);
+
+		// Values of every metric at one time, the histograms summarized since the previous snapshot
+		struct Snapshot {
+			struct Value {
+				const std::string *name;        // Owned by the registry
+				const char *type;               // "counter", "gauge" or "histogram"
+				bool histogram;
+				int64_t value;                  // Counters and gauges
+				Histogram::Summary summary;     // Histograms
+			};
+
+			double time;                        // Seconds since the first metric was registered
+			std::vector<Value> values;          // Sorted by name
+		};
+
+		// No I/O, and no allocation once the snapshot holds every metric : the snapshot can be taken in a tick and written elsewhere
+		static void takeSnapshot(Snapshot& snapshot);
+
+		// Appends a snapshot of every metric to the file : one JSON object per line if its name ends with ".json",
+		// CSV rows (time, name, type, value, count, mean, p50, p90, p99, max) otherwise.
+		// Returns false if the file cannot be written.
+		static bool writeSnapshot(const Snapshot& snapshot, const std::string& filename);
+		// Takes the snapshot and writes it
+		static bool writeSnapshot(const std::string& filename);
+
+	private:
+		struct Registry;
+		static Registry& registry();
+
+		// Slot of the calling thread in the counters
+		static unsigned int threadSlot() {
+			static std::atomic<unsigned int> threads(0);
+			thread_local unsigned int slot = threads.fetch_add(1, std::memory_order_relaxed) % Counter::Slots;
+			return slot;
+		}
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef MECHA_POOL_HPP
+#define MECHA_POOL_HPP
+
+#include <stdint.h>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed capacity storage of objects which are created and destroyed constantly.
+ * Everything is allocated once, creating and destroying are O(1) and never allocate, the addresses are stable.
+ * Handles are generation-checked : a handle to a destroyed object is detected instead of reaching the object reusing its slot.
+ */
+template<typename T>
+class Pool {
+	public:
+		struct Handle {
+			Handle() : index(Invalid), generation(0) {}
+			Handle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+			bool isNull() const { return index == Invalid; }
+			bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+			bool operator!=(const Handle& other) const { return !(*this == other); }
+
+			uint32_t index;
+			uint32_t generation;
+		};
+
+	public:
+		explicit Pool(size_t capacity) :
+			storage(new Storage[capacity]),
+			generations(capacity, 0),
+			livePositions(capacity, Absent)
+		{
+			freeIndices.reserve(capacity);
+			live.reserve(capacity);
+
+			// Lowest indices first
+			for (size_t i = capacity; i > 0; --i)
+				freeIndices.push_back((uint32_t)(i - 1));
+		}
+
+		~Pool() { clear(); }
+
+		Pool(const Pool&) = delete;
+		Pool& operator=(const Pool&) = delete;
+
+		// Returns a null handle if the pool is full
+		template<typename... Args>
+		Handle create(Args&&... args) {
+			if (freeIndices.empty())
+				return Handle();
+
+			const uint32_t index = freeIndices.back();
+			new (&storage[index]) T(std::forward<Args>(args)...);
+			freeIndices.pop_back();
+
+			livePositions[index] = (uint32_t)live.size();
+			live.push_back(index);
+
+			return Handle(index, generations[index]);
+		}
+
+		// Ignored if the handle is stale
+		void destroy(const Handle& handle) {
+			if (valid(handle))
+				release(handle.index);
+		}
+		// The item must be alive
+		void destroy(T* item) { release(indexOf(item)); }
+
+		bool valid(const Handle& handle) const {
+			return handle.index < generations.size() && livePositions[handle.index] != Absent && generations[handle.index] == handle.generation;
+		}
+
+		// nullptr if the handle is stale
+		T* get(const Handle& handle) { return valid(handle) ? item(handle.index) : nullptr; }
+		const T* get(const Handle& handle) const { return valid(handle) ? item(handle.index) : nullptr; }
+
+		Handle handleOf(const T* item) const { const uint32_t index = indexOf(item); return Handle(index, generations[index]); }
+
+		// Live items, in no particular order. Destroying the item at i moves the last one to i.
+		size_t size() const { return live.size(); }
+		T& at(size_t i) { return *item(live[i]); }
+		const T& at(size_t i) const { return *item(live[i]); }
+
+		size_t capacity() const { return generations.size(); }
+		// Bytes reserved by the storage and the bookkeeping, constant once constructed
+		size_t memoryUsage() const {
+			return capacity() * sizeof(Storage)
+				+ (generations.capacity() + freeIndices.capacity() + live.capacity() + livePositions.capacity()) * sizeof(uint32_t);
+		}
+		bool full() const { return freeIndices.empty(); }
+
+		void clear() {
+			while (!live.empty())
+				release(live.back());
+		}
+
+	private:
+		typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+		enum : uint32_t { Invalid = 0xFFFFFFFF, Absent = 0xFFFFFFFF };
+
+		T* item(uint32_t index) { return reinterpret_cast<T*>(&storage[index]); }
+		const T* item(uint32_t index) const { return reinterpret_cast<const T*>(&storage[index]); }
+		uint32_t indexOf(const T* item) const { return (uint32_t)(reinterpret_cast<const Storage*>(item) - storage.get()); }
+
+		void release(uint32_t index) {
+			item(index)->~T();
+			generations[index]++;
+
+			// The last live item fills the hole
+			const uint32_t position = livePositions[index];
+			live[position] = live.back();
+			livePositions[live[position]] = position;
+			live.pop_back();
+			livePositions[index] = Absent;
+
+			freeIndices.push_back(index);
+		}
+
+	private:
+		std::unique_ptr<Storage[]> storage;
+		std::vector<uint32_t> generations;      // Incremented each time the slot is released
+		std::vector<uint32_t> freeIndices;
+		std::vector<uint32_t> live;             // Indices of the live items
+		std::vector<uint32_t> livePositions;    // Index -> position in live, Absent when free
+};
+
+#endif
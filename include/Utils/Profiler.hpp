@@ -0,0 +1,79 @@
+#ifndef MECHA_PROFILER_HPP
+#define MECHA_PROFILER_HPP
+
+/**
+ * Scoped CPU zones, written by each thread into its own ring buffer and dumped as a Chrome trace
+ * (chrome://tracing or https://ui.perfetto.dev), the nesting of the zones giving the hierarchy.
+ * Only built with the MECHA_PROFILER CMake option, the macros compile to nothing otherwise :
+ *   MECHA_PROFILE_ZONE("name")      Measures the enclosing scope, the name must be a string literal
+ *   MECHA_PROFILE_THREAD("name")    Names the calling thread in the trace
+ *   MECHA_PROFILE_DUMP("file")      Writes the zones still in the ring buffers
+ */
+
+#ifdef MECHA_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+class Profiler {
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		// Zones kept per thread, the oldest ones are overwritten
+		enum : uint32_t { BufferSize = 1 << 16 };
+
+		class Zone {
+			public:
+				explicit Zone(const char *name) : name(name), start(Clock::now()) {}
+				~Zone() { Profiler::record(name, start, Clock::now()); }
+
+				Zone(const Zone&) = delete;
+				Zone& operator=(const Zone&) = delete;
+
+			private:
+				const char *name;
+				Clock::time_point start;
+		};
+
+	public:
+		static void setThreadName(const char *name);
+
+		// Can be called from any thread while the others keep recording, the zones being overwritten are skipped.
+		// Returns false if the file cannot be written.
+		static bool dump(const std::string& filename);
+
+	private:
+		struct Event {
+			const char *name;
+			Clock::time_point start, end;
+		};
+
+		struct ThreadBuffer;
+
+		static void record(const char *name, const Clock::time_point& start, const Clock::time_point& end);
+		// Buffer of the calling thread, created on its first zone
+		static ThreadBuffer& buffer();
+		static std::vector<std::unique_ptr<ThreadBuffer>>& allBuffers();
+};
+
+#define MECHA_PROFILE_CONCAT_(a, b) a##b
+#define MECHA_PROFILE_CONCAT(a, b) MECHA_PROFILE_CONCAT_(a, b)
+
+#define MECHA_PROFILE_ZONE(name) Profiler::Zone MECHA_PROFILE_CONCAT(profilerZone, __LINE__)(name)
+#define MECHA_PROFILE_THREAD(name) Profiler::setThreadName(name)
+#define MECHA_PROFILE_DUMP(file) Profiler::dump(file)
+
+#else
+
+#define MECHA_PROFILE_ZONE(name)
+#define MECHA_PROFILE_THREAD(name)
+#define MECHA_PROFILE_DUMP(file)
+
+#endif
+
+#endif
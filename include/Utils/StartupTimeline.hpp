@@ -0,0 +1,43 @@
+#ifndef MECHA_STARTUPTIMELINE_HPP
+#define MECHA_STARTUPTIMELINE_HPP
+
+#include <chrono>
+#include <ostream>
+
+/**
+ * Time spent in each stage of the startup, from the start of the process to the first presented frame.
+ * A stage is a scope timed by a StartupTimeline::Stage, on any thread, the stages may nest.
+ * Once the first frame is presented the stages are not recorded anymore : the code shared with the running game costs nothing.
+ * The time to first frame is also published as the startup.first_frame_us metric.
+ */
+class StartupTimeline {
+	public:
+		class Stage {
+			public:
+				// The name must be a string literal
+				explicit Stage(const char *name);
+				~Stage();
+
+				Stage(const Stage&) = delete;
+				Stage& operator=(const Stage&) = delete;
+
+			private:
+				const char *name;
+				std::chrono::steady_clock::time_point start;
+				unsigned int depth;
+				bool recorded;
+		};
+
+	public:
+		// Ends the startup, only the first call counts
+		static void firstFrame();
+		static bool isOver();
+
+		// Since the process started, zero until the first frame
+		static std::chrono::duration<float> getTimeToFirstFrame();
+
+		// The stages in starting order with their start, their duration and their thread
+		static void report(std::ostream& out);
+};
+
+#endif
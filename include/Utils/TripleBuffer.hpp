@@ -0,0 +1,48 @@
+#ifndef MECHA_TRIPLEBUFFER_HPP
+#define MECHA_TRIPLEBUFFER_HPP
+
+#include <atomic>
+
+/**
+ * Lock-free hand-off of a value from one writer thread to one reader thread.
+ * The writer fills its buffer then publishes it, the reader fetches the latest published buffer.
+ * Neither side ever waits : the writer overwrites the buffers the reader did not fetch, the reader keeps the last one.
+ * Buffers are recycled, so that their content (and the capacity of their containers) is reused.
+ */
+template<typename T>
+class TripleBuffer {
+	public:
+		TripleBuffer() : back(0), middle(1), front(2) {}
+
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		// Writer side
+		T& writeBuffer() { return buffers[back]; }
+		void publish() {
+			back = middle.exchange(back | Dirty, std::memory_order_acq_rel) & Index;
+		}
+
+		// Reader side, returns true if a buffer was published since the last fetch
+		bool fetch() {
+			if (!(middle.load(std::memory_order_relaxed) & Dirty))
+				return false;
+
+			front = middle.exchange(front, std::memory_order_acq_rel) & Index;
+			return true;
+		}
+		const T& readBuffer() const { return buffers[front]; }
+
+	private:
+		enum : unsigned int {
+			Index = 3,
+			Dirty = 4       // Set on the middle buffer when it holds a value not fetched yet
+		};
+
+		T buffers[3];
+		unsigned int back;                  // Only accessed by the writer
+		std::atomic<unsigned int> middle;   // Index of the buffer exchanged between both sides
+		unsigned int front;                 // Only accessed by the reader
+};
+
+#endif
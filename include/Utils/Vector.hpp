@@ -62,6 +62,18 @@ inline Vector2<T> operator-(const Vector2<T>& l, const Vector2<T>& r) { return V
 template<typename T>
 inline Vector2<T>& operator-=(Vector2<T>& l, const Vector2<T>& r) { l.x -= r.x; l.y -= r.y; return l; }
 
+// v * s
+template<typename T>
+inline Vector2<T> operator*(const Vector2<T>& v, const T& s) { return Vector2<T>(v.x * s, v.y * s); }
+
+// s * v
+template<typename T>
+inline Vector2<T> operator*(const T& s, const Vector2<T>& v) { return Vector2<T>(v.x * s, v.y * s); }
+
+// v *= s
+template<typename T>
+inline Vector2<T>& operator*=(Vector2<T>& v, const T& s) { v.x *= s; v.y *= s; return v; }
+
 // l == r ?
 template<typename T>
 inline Vector2<T> operator==(const Vector2<T>& l, const Vector2<T>& r) { return l.x == r.x && l.y == r.y; }
@@ -1,6 +1,9 @@
 #ifndef MECHA_WINDOW_HPP
 #define MECHA_WINDOW_HPP
 
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+
 struct SDL_Window;
 
 class Window {
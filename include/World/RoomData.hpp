@@ -0,0 +1,48 @@
+#ifndef MECHA_ROOMDATA_HPP
+#define MECHA_ROOMDATA_HPP
+
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+#include "ResourcesID.hpp"
+#include "ECS/Components.hpp"
+#include "Utils/Vector.hpp"
+
+/**
+ * Static description of a room, read from Room::fileName(id), one element per line :
+ *   bounds <x> <y> <w> <h>            Area of the room in world coordinates
+ *   image <Image::ID>                 Image used by the room
+ *   door <Room::ID> <x> <y> <w> <h>   Passage to an adjacent room, taken when the player leaves the bounds inside it
+ *   solid <x> <y> <w> <h>             Collision rectangle
+ *   enemy <idle|patrol|chase> <x> <y> <speed> <range>
+ *                                     Enemy placed in the room the first time it is populated (see WorldManager)
+ * Empty lines and lines starting with '#' are ignored.
+ */
+
+struct Door {
+	Room::ID target;
+	SDL_Rect area;
+};
+
+struct EnemyPlacement {
+	ECS::AI::Behaviour behaviour;
+	Vector2f position;
+	float speed;
+	float range;
+};
+
+struct RoomData {
+	Room::ID id;
+	SDL_Rect bounds;
+	std::vector<Image::ID> images;
+	std::vector<Door> doors;      // The doors define the rooms adjacency graph
+	std::vector<SDL_Rect> solids;
+	std::vector<EnemyPlacement> enemies;
+
+	// Returns false if the file does not exist, throws if it is malformed
+	bool loadFromFile(Room::ID roomID, const std::string& filename);
+};
+
+#endif
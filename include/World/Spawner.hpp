@@ -0,0 +1,108 @@
+#ifndef MECHA_SPAWNER_HPP
+#define MECHA_SPAWNER_HPP
+
+#include <stddef.h>
+
+#include "ECS/Registry.hpp"
+#include "ECS/Components.hpp"
+#include "ResourcesID.hpp"
+#include "TextureHandle.hpp"
+#include "Utils/Pool.hpp"
+#include "Utils/Vector.hpp"
+
+class AnimationSystem;
+class ResourcesLoader;
+
+struct Projectile {
+	ECS::Entity entity;
+	float lifetime;         // Seconds left
+};
+
+struct Particle {
+	ECS::Entity entity;
+	float lifetime;         // Seconds left
+};
+
+struct Enemy {
+	ECS::Entity entity;
+};
+
+/**
+ * Spawns and despawns the short lived entities : projectiles, particles and enemies.
+ * Each kind has a fixed capacity, reserved up front in the registry, the animations and the pools of this class,
+ * so that spawning and despawning are O(1) and never allocate during the game.
+ * The enemies physics bodies come from the pool of the MPhysacWorld.
+ */
+class Spawner {
+	public:
+		enum Kind {
+			Projectiles,
+			Particles,
+			Enemies,
+			KindsCount
+		};
+
+		struct Capacities {
+			size_t projectiles;
+			size_t particles;
+			size_t enemies;
+		};
+
+		typedef Pool<Projectile>::Handle ProjectileHandle;
+		typedef Pool<Particle>::Handle ParticleHandle;
+		typedef Pool<Enemy>::Handle EnemyHandle;
+
+	public:
+		Spawner(ECS::Registry& registry, AnimationSystem& animations, const Capacities& capacities);
+
+		Spawner(const Spawner&) = delete;
+		Spawner& operator=(const Spawner&) = delete;
+
+		// Sprite drawn for the entities of a kind, none by default
+		void setSprite(Kind kind, ResourcesLoader& rl, Animation::ID clip);
+
+		// The handles are null once the kind is at its capacity
+		ProjectileHandle spawnProjectile(const Vector2f& position, const Vector2f& velocity, float lifetime);
+		ParticleHandle spawnParticle(const Vector2f& position, const Vector2f& velocity, float lifetime);
+		EnemyHandle spawnEnemy(const Vector2f& position, ECS::AI::Behaviour behaviour, float speed, float range);
+
+		// Gives an enemy entity its physics body, returns false if the bodies pool is full
+		bool attachEnemyBody(ECS::Entity entity);
+
+		// Stale handles are ignored
+		void despawn(const ProjectileHandle& handle);
+		void despawn(const ParticleHandle& handle);
+		void despawn(const EnemyHandle& handle);
+
+		// NullEntity if the handle is stale
+		ECS::Entity getEntity(const ProjectileHandle& handle) const { const Projectile *p = projectiles.get(handle); return p ? p->entity : ECS::NullEntity; }
+		ECS::Entity getEntity(const ParticleHandle& handle) const { const Particle *p = particles.get(handle); return p ? p->entity : ECS::NullEntity; }
+		ECS::Entity getEntity(const EnemyHandle& handle) const { const Enemy *e = enemies.get(handle); return e ? e->entity : ECS::NullEntity; }
+
+		// Despawns the expired projectiles and particles, and forgets the enemies destroyed by the systems
+		void update(float dt);
+
+		size_t getCount(Kind kind) const;
+		size_t getCapacity(Kind kind) const;
+
+	private:
+		struct SpriteKind {
+			TextureHandle texture;
+			Animation::ID clip;
+			bool enabled;
+		};
+
+		ECS::Entity create(Kind kind, const Vector2f& position, const Vector2f& velocity);
+
+	private:
+		ECS::Registry &registry;
+		AnimationSystem &animations;
+
+		Pool<Projectile> projectiles;
+		Pool<Particle> particles;
+		Pool<Enemy> enemies;
+
+		SpriteKind sprites[KindsCount];
+};
+
+#endif
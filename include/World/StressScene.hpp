@@ -0,0 +1,94 @@
+#ifndef MECHA_STRESSSCENE_HPP
+#define MECHA_STRESSSCENE_HPP
+
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+#include "ECS/Registry.hpp"
+#include "World/Spawner.hpp"
+
+class ResourcesLoader;
+
+/**
+ * Profiling scene : grows a population step by step until the ticks go over the frame budget,
+ * to measure the largest population each subsystem sustains.
+ * Each kind of the mix is ramped alone, then the whole mix together. A step spawns the mix once,
+ * lets the scene settle, then measures the mean cost of the ticks : the population before the first step
+ * over the budget is the result of the phase.
+ * The physics bodies are dropped into a closed box covering the area, the positions and shapes are seeded
+ * so that two runs of a build spawn the same scene.
+ */
+class StressScene {
+	public:
+		// Entities spawned by each step
+		struct Mix {
+			unsigned int boxes;
+			unsigned int circles;
+			unsigned int polygons;     // Regular polygons of 3 to 8 sides and random radius
+			unsigned int sprites;      // Animated sprites without body
+			unsigned int enemies;      // AI driven enemies with a body
+		};
+
+	public:
+		StressScene(ECS::Registry& registry, Spawner& spawner, ResourcesLoader& rl, const Mix& mix, const SDL_Rect& area, float budgetMs);
+		~StressScene();
+
+		StressScene(const StressScene&) = delete;
+		StressScene& operator=(const StressScene&) = delete;
+
+		// Once per tick, with the time the last tick cost (update and rendering). Returns false once every phase is over.
+		bool update(float costMs);
+
+		bool isOver() const { return current >= phases.size(); }
+
+		// Result of each phase and its first step over the budget, ">=" when the pools were full before the budget
+		void report(std::ostream& out) const;
+
+		// "boxes:32,circles:32,polygons:16,sprites:128,enemies:8", the missing kinds are not spawned. Throws if malformed.
+		static Mix parseMix(const std::string& text);
+		static Mix defaultMix();
+
+	private:
+		struct Phase {
+			std::string name;
+			Mix mix;
+			size_t sustained;           // Largest population under the budget
+			float cost;                 // Mean tick cost of that population, in milliseconds
+			size_t overPopulation;      // First population over the budget, 0 if none
+			float overCost;
+			bool capped;                // Stopped by a full pool rather than by the budget
+		};
+
+		// Returns false if a pool is full
+		bool spawnStep(const Mix& mix);
+		bool spawnBody(unsigned int kind);
+		void createWalls();
+		void clear();
+
+		Vector2f randomPosition();
+
+	private:
+		ECS::Registry &registry;
+		Spawner &spawner;
+		SDL_Rect area;
+		float budget;
+
+		std::vector<Phase> phases;
+		size_t current;
+
+		unsigned int ticks;             // Since the last step
+		float costSum;
+		size_t population;
+
+		std::vector<ECS::Entity> entities;      // Bodies and walls of the phase
+		std::vector<Spawner::ParticleHandle> sprites;
+		std::vector<Spawner::EnemyHandle> enemies;
+
+		std::minstd_rand random;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef MECHA_WORLDMANAGER_HPP
+#define MECHA_WORLDMANAGER_HPP
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <stdint.h>
+
+#include "ECS/Registry.hpp"
+#include "ECS/Components.hpp"
+#include "World/RoomData.hpp"
+#include "World/Spawner.hpp"
+#include "Utils/Vector.hpp"
+
+/**
+ * Simulation level of detail of the rooms, so that the cost of the physics and the AI depends on the area around
+ * the player rather than on the size of the map :
+ *   Active  : the current room, fully simulated with physics bodies
+ *   Nearby  : the rooms behind its doors, their entities are asleep (no body) and stepped every few ticks
+ *   Dormant : the other rooms, their entities are stored as plain values out of the registry
+ * A room is populated with its enemies the first time it becomes Active or Nearby, its stored state is used afterwards.
+ */
+class WorldManager {
+	public:
+		enum Lod : uint8_t {
+			Active,
+			Nearby,
+			Dormant
+		};
+
+		struct Stats {
+			unsigned int rooms;         // Rooms populated at least once
+			unsigned int active;        // Entities simulated with a body
+			unsigned int nearby;        // Entities asleep
+			unsigned int stored;        // Entities out of the registry
+		};
+
+	public:
+		// The nearby rooms are stepped once every nearbyPeriod ticks
+		WorldManager(ECS::Registry& registry, Spawner& spawner, unsigned int nearbyPeriod = 8);
+
+		WorldManager(const WorldManager&) = delete;
+		WorldManager& operator=(const WorldManager&) = delete;
+
+		// Can be called from the streaming thread : the rooms are copied and applied by the next update().
+		// adjacent holds the loaded rooms behind the doors of current, the others are populated once loaded and entered.
+		void enterRoom(const RoomData& current, const std::vector<const RoomData*>& adjacent);
+
+		// Simulation thread, before the systems
+		void update(float dt, const Vector2f& target);
+
+		// Simulation thread
+		Lod getLod(Room::ID room) const;
+		// Counts at the last room change, can be read from any thread
+		Stats getStats() const;
+
+	private:
+		// Enemy out of the registry
+		struct StoredEnemy {
+			ECS::Transform transform;
+			ECS::Vitals vitals;
+			ECS::AI ai;
+			bool hasBody;
+		};
+
+		struct RoomState {
+			Lod lod;
+			std::vector<Spawner::EnemyHandle> live;
+			std::vector<StoredEnemy> stored;
+		};
+
+		void applyPending();
+		void setLod(RoomState& state, Lod lod);
+		void populate(const RoomData& room, RoomState& state);
+
+		void store(RoomState& state);
+		void restore(RoomState& state, Lod lod);
+		void sleep(ECS::Entity entity);
+		void wake(ECS::Entity entity);
+
+	private:
+		ECS::Registry &registry;
+		Spawner &spawner;
+
+		std::map<Room::ID, RoomState> rooms;    // Populated rooms
+
+		unsigned int nearbyPeriod;
+		unsigned int ticks;
+		float nearbyDt;                         // Time since the last step of the nearby rooms
+
+		// Room change waiting for the simulation thread
+		mutable std::mutex pendingMutex;
+		std::atomic<bool> hasPending;
+		RoomData pendingRoom;
+		std::vector<RoomData> pendingAdjacent;
+
+		std::atomic<unsigned int> roomsCount, activeCount, nearbyCount, storedCount;
+};
+
+#endif
@@ -1,43 +1,32 @@
 #include "AnimatedSprite.hpp"
 
-#include <iostream>
-
 #include <SDL.h>
 
 #include "Painter.hpp"
 #include "ResourcesLoader.hpp"
 #include "ResourcesID.hpp"
+#include "Animation/AnimationSystem.hpp"
 
-std::map<Image::ID, std::vector<SDL_Rect>> AnimatedSprite::srcRects;
-
-AnimatedSprite::AnimatedSprite(ResourcesLoader &rl, Image::ID id, const std::vector<SDL_Rect>& sRects, std::chrono::duration<float> stepD) :
-	resources(rl),
-	imgID(id),
-	currentStep(0),
-	stepDuration(stepD),
-	dtStep(0.f)
+AnimatedSprite::AnimatedSprite(AnimationSystem &as, ResourcesLoader &rl, Animation::ID clip) :
+	animations(as),
+	texture(rl, as.getClip(clip).image),
+	state(as.create(clip))
 {
-	if (srcRects.find(id) == srcRects.end()) {
-		srcRects.insert(std::make_pair(id, sRects));
-	}
-
 	dstRect.x = 0; dstRect.y = 0;
-	dstRect.w = sRects[0].w; dstRect.h = sRects[0].h;
-	
-	resources.load(imgID);
+	dstRect.w = 0; dstRect.h = 0;
 }
 
-AnimatedSprite::~AnimatedSprite() {}
+AnimatedSprite::~AnimatedSprite() {
+	animations.destroy(state);
+}
 
-void AnimatedSprite::update(const std::chrono::duration<float>& dt) {
-	dtStep += dt;
-	if (dtStep >= stepDuration) {
-		dtStep -= stepDuration;
-		currentStep++;
-		currentStep %= srcRects[imgID].size();
-	}
+void AnimatedSprite::setCurrentStep(uint16_t step) {
+	animations.setFrame(state, step);
 }
 
 void AnimatedSprite::draw(const Painter& painter) const {
-	SDL_RenderCopy(painter.renderer, resources.get(imgID), &(srcRects[imgID][currentStep]), &dstRect);
-}
\ No newline at end of file
+	const SDL_Rect &src = animations.getFrame(state);
+	SDL_Rect dst = { dstRect.x, dstRect.y, src.w, src.h };
+
+	painter.copy(texture, src, dst);
+}
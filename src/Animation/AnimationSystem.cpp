@@ -0,0 +1,107 @@
+#include "Animation/AnimationSystem.hpp"
+
+#include <stdexcept>
+
+#include "ResourcesLoader.hpp"
+
+AnimationSystem::AnimationSystem(ResourcesLoader &rl) :
+	resources(rl),
+	framesVersion(rl.getFramesVersion()),
+	clips(Animation::Count)
+{
+	for (auto &clip : clips) {
+		clip.image = Image::Count;
+		clip.stepDuration = 1.f;
+		clip.firstFrame = 0;
+		clip.framesCount = 0;
+	}
+}
+
+void AnimationSystem::defineClip(Animation::ID clip, Image::ID image, float stepDuration) {
+	if (stepDuration <= 0.f)
+		throw std::runtime_error("[Error] AnimationSystem::defineClip - the step duration must be positive");
+
+	clips[clip].image = image;
+	clips[clip].stepDuration = stepDuration;
+
+	compile();
+}
+
+uint32_t AnimationSystem::create(Animation::ID clip) {
+	if (clips[clip].framesCount == 0)
+		throw std::runtime_error("[Error] AnimationSystem::create - the clip is not defined");
+
+	AnimationState state;
+	state.elapsed = 0.f;
+	state.clip = (uint16_t)clip;
+	state.frame = 0;
+
+	if (freeStates.empty()) {
+		states.push_back(state);
+		return (uint32_t)(states.size() - 1);
+	}
+
+	uint32_t index = freeStates.back();
+	freeStates.pop_back();
+	states[index] = state;
+
+	return index;
+}
+
+void AnimationSystem::destroy(uint32_t state) {
+	states[state].clip = FreeState;
+	freeStates.push_back(state);
+}
+
+void AnimationSystem::setFrame(uint32_t state, uint16_t frame) {
+	AnimationState &s = states[state];
+	const uint32_t framesCount = clips[s.clip].framesCount;
+
+	s.frame = framesCount ? (uint16_t)(frame % framesCount) : 0;
+	s.elapsed = 0.f;
+}
+
+void AnimationSystem::update(float dt) {
+	// Hot reloaded frames
+	if (framesVersion != resources.getFramesVersion())
+		compile();
+
+	const AnimationClip *clipsData = clips.data();
+
+	for (AnimationState &state : states) {
+		if (state.clip == FreeState)
+			continue;
+
+		const AnimationClip &clip = clipsData[state.clip];
+
+		state.elapsed += dt;
+		while (state.elapsed >= clip.stepDuration) {
+			state.elapsed -= clip.stepDuration;
+			const uint32_t next = (uint32_t)state.frame + 1;
+			state.frame = (next >= clip.framesCount) ? 0 : (uint16_t)next;
+		}
+	}
+}
+
+// Copies the frames of every defined clip next to each other
+void AnimationSystem::compile() {
+	frames.clear();
+
+	for (auto &clip : clips) {
+		if (clip.image == Image::Count)
+			continue;
+
+		const std::vector<SDL_Rect> &rects = resources.getFrames(clip.image);
+
+		clip.firstFrame = (uint32_t)frames.size();
+		clip.framesCount = (uint32_t)rects.size();
+		frames.insert(frames.end(), rects.begin(), rects.end());
+	}
+
+	// The clips may be shorter than before
+	for (auto &state : states)
+		if (state.clip != FreeState && state.frame >= clips[state.clip].framesCount)
+			state.frame = 0;
+
+	framesVersion = resources.getFramesVersion();
+}
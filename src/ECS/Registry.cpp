@@ -0,0 +1,59 @@
+#include "ECS/Registry.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+namespace ECS {
+	namespace {
+		const uint32_t MaxVersion = NullEntity >> IndexBits;
+	}
+
+	Registry::~Registry() {
+		for (auto e : slots)
+			if (valid(e))
+				destroy(e);
+	}
+
+	unsigned int Registry::nextTypeID() {
+		static std::atomic<unsigned int> next(0);
+		return next++;
+	}
+
+	Entity Registry::create() {
+		uint32_t index;
+
+		if (!freeIndices.empty()) {
+			index = freeIndices.back();
+			freeIndices.pop_back();
+
+			slots[index] = (versionOf(slots[index]) << IndexBits) | index;
+		} else {
+			// IndexMask itself marks the destroyed entities
+			if (slots.size() >= IndexMask)
+				throw std::runtime_error("[Error] ECS::Registry::create - too many entities");
+
+			index = (uint32_t)slots.size();
+			slots.push_back(index);
+		}
+
+		alive++;
+		return slots[index];
+	}
+
+	void Registry::destroy(Entity e) {
+		if (!valid(e))
+			return;
+
+		for (auto &pool : pools)
+			if (pool)
+				pool->remove(e);
+
+		// The version wraps around : a handle kept across that many reuses of its index would be valid again
+		const uint32_t index = indexOf(e);
+		const uint32_t version = (versionOf(e) + 1) % MaxVersion;
+		slots[index] = (version << IndexBits) | IndexMask;
+
+		freeIndices.push_back(index);
+		alive--;
+	}
+}
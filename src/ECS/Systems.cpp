@@ -0,0 +1,141 @@
+#include "ECS/Systems.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <SDL.h>
+
+#include "Painter.hpp"
+#include "Animation/AnimationSystem.hpp"
+#include "MPhysac/MPhysacBody.hpp"
+#include "MPhysac/MPhysacWorld.hpp"
+#include "Utils/AllocTracker.hpp"
+#include "Utils/FrameArena.hpp"
+#include "Utils/Profiler.hpp"
+
+namespace {
+	// Velocity wanted by the AI of an entity
+	void steer(const ECS::AI& ai, ECS::Transform& transform, const Vector2f& target) {
+		switch (ai.behaviour) {
+		case ECS::AI::Idle:
+			transform.velocity = Vector2f();
+			break;
+		case ECS::AI::Patrol:
+			// Turns back once out of range, keeps its direction otherwise
+			if (transform.velocity.x == 0.f)
+				transform.velocity = Vector2f(ai.speed, 0.f);
+			else if ((transform.position.x - ai.origin.x) * transform.velocity.x > ai.range * ai.speed)
+				transform.velocity.x = -transform.velocity.x;
+			break;
+		case ECS::AI::Chase: {
+			const Vector2f toTarget(target - transform.position);
+			const float distance = std::sqrt(toTarget.x * toTarget.x + toTarget.y * toTarget.y);
+
+			if (distance > ai.range || distance == 0.f)
+				transform.velocity = Vector2f();
+			else
+				transform.velocity = toTarget * (ai.speed / distance);
+		} break;
+		}
+	}
+}
+
+namespace ECS {
+	void connectHooks(Registry& registry, AnimationSystem& animations) {
+		registry.pool<PhysicsHandle>().setOnRemove([](Entity, PhysicsHandle& handle) {
+			MPhysacWorld::getInstance().DestroyMPhysacBody(handle.body);
+			handle.body = nullptr;
+		});
+
+		registry.pool<Sprite>().setOnRemove([&animations](Entity, Sprite& sprite) {
+			animations.destroy(sprite.animation);
+		});
+	}
+
+	void updateAI(Registry& registry, const Vector2f& target) {
+		MECHA_PROFILE_ZONE("ECS::updateAI");
+		MECHA_ALLOC_HOT_PATH("ECS::updateAI");
+
+		ComponentPool<PhysicsHandle> &bodies = registry.pool<PhysicsHandle>();
+		ComponentPool<Asleep> &asleep = registry.pool<Asleep>();
+
+		registry.each<AI, Transform>([&target, &bodies, &asleep](Entity e, AI& ai, Transform& transform) {
+			if (asleep.has(e))
+				return;
+
+			steer(ai, transform, target);
+
+			if (bodies.has(e))
+				bodies.get(e).body->velocity = transform.velocity;
+		});
+	}
+
+	void integrateMovement(Registry& registry, float dt) {
+		MECHA_PROFILE_ZONE("ECS::integrateMovement");
+		MECHA_ALLOC_HOT_PATH("ECS::integrateMovement");
+
+		ComponentPool<Transform> &transforms = registry.pool<Transform>();
+		ComponentPool<PhysicsHandle> &bodies = registry.pool<PhysicsHandle>();
+		ComponentPool<Asleep> &asleep = registry.pool<Asleep>();
+
+		for (size_t i = 0; i < transforms.size(); ++i) {
+			const Entity e = transforms.entityAt(i);
+			if (bodies.has(e) || asleep.has(e))
+				continue;
+
+			Transform &transform = transforms.at(i);
+			transform.position += transform.velocity * dt;
+		}
+	}
+
+	void updateAsleep(Registry& registry, const Vector2f& target, float dt) {
+		MECHA_PROFILE_ZONE("ECS::updateAsleep");
+		MECHA_ALLOC_HOT_PATH("ECS::updateAsleep");
+
+		ComponentPool<AI> &ais = registry.pool<AI>();
+
+		registry.each<Asleep, Transform>([&target, &ais, dt](Entity e, Asleep&, Transform& transform) {
+			if (ais.has(e))
+				steer(ais.get(e), transform, target);
+
+			transform.position += transform.velocity * dt;
+		});
+	}
+
+	void syncPhysics(Registry& registry) {
+		MECHA_PROFILE_ZONE("ECS::syncPhysics");
+		MECHA_ALLOC_HOT_PATH("ECS::syncPhysics");
+
+		registry.each<PhysicsHandle, Transform>([](Entity, PhysicsHandle& handle, Transform& transform) {
+			transform.position = handle.body->position;
+			transform.velocity = handle.body->velocity;
+		});
+	}
+
+	void removeDead(Registry& registry) {
+		MECHA_PROFILE_ZONE("ECS::removeDead");
+		MECHA_ALLOC_HOT_PATH("ECS::removeDead");
+
+		ArenaVector<Entity> dead;
+
+		registry.each<Vitals>([&registry, &dead](Entity e, Vitals& vitals) {
+			if (vitals.lifePoints <= 0 && !registry.has<PlayerControl>(e))
+				dead.push_back(e);
+		});
+
+		for (auto e : dead)
+			registry.destroy(e);
+	}
+
+	void drawSprites(Registry& registry, const AnimationSystem& animations, const Painter& painter) {
+		MECHA_PROFILE_ZONE("ECS::drawSprites");
+		MECHA_ALLOC_HOT_PATH("ECS::drawSprites");
+
+		registry.each<Sprite, Transform>([&animations, &painter](Entity, Sprite& sprite, Transform& transform) {
+			const SDL_Rect &src = animations.getFrame(sprite.animation);
+			const SDL_Rect dst = { (int)transform.position.x, (int)transform.position.y, src.w, src.h };
+
+			painter.copy(sprite.texture, src, dst);
+		});
+	}
+}
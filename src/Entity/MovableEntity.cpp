@@ -1,14 +0,0 @@
-/*******************************************************************************************
-*   MovableEntity.cpp
-*
-*   This file designs the PlayerEntity class based for the player
-*
-********************************************************************************************/
-
-#include <iostream>
-
-#include "Entity/MovableEntity.hpp"
-
-MovableEntity::MovableEntity() : Entity() {
-    std::cout<<"Creating movable entity"<<std::endl;
-};
\ No newline at end of file
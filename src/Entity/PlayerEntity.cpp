@@ -8,12 +8,15 @@
 #include <iostream>
 
 #include "Entity/PlayerEntity.hpp"
-#include "MPhysac/MPhysacBody.hpp"
-#include "MPhysac/MPhysacWorld.hpp"
+#include "Animation/AnimationSystem.hpp"
+#include "ResourcesLoader.hpp"
+#include "Utils/StartupTimeline.hpp"
 
-PlayerEntity::PlayerEntity(ResourcesLoader &rl)
+PlayerEntity::PlayerEntity(ECS::Registry& registry, ResourcesLoader &rl, AnimationSystem &as) :
+    registry(registry),
+    entity(registry.create())
 {
-    position += Vector2f(10,10);
+    StartupTimeline::Stage stage("PlayerEntity");
 
     std::vector<SDL_Rect> rects(8);
 	for (int i = 0; i < 8; ++i) {
@@ -21,14 +24,19 @@ PlayerEntity::PlayerEntity(ResourcesLoader &rl)
 		rects[i].w = 64; rects[i].h = 64;
 	}
 
-	playerSprite = new AnimatedSprite(rl, Image::Player, rects, std::chrono::duration<float>(0.1));
-    playerSprite->setPosition((Vector2i)position);
+	rl.defineFrames(Image::Player, rects);
+	as.defineClip(Animation::Player, Image::Player, 0.1f);
+
+    registry.assign<ECS::Transform>(entity, Vector2f(10, 10), Vector2f());
+    registry.assign<ECS::Sprite>(entity, TextureHandle(rl, Image::Player), as.create(Animation::Player));
+    registry.assign<ECS::Vitals>(entity, 100, 100);
+    registry.assign<ECS::PlayerControl>(entity);
 
 	initInput();
 }
 
 PlayerEntity::~PlayerEntity() {
-    delete playerSprite;
+    registry.destroy(entity);
 }
 
 void PlayerEntity::initInput() {
@@ -44,4 +52,4 @@ void PlayerEntity::initInput() {
 	bind(PlayerAction::MoveRight, Action(SDL_SCANCODE_RIGHT, (Action::Type)(Action::Type::Pressed | Action::Type::RealTime)), [this]() {
 		move(Vector2f(5.f, 0.f));
 	});
-}
\ No newline at end of file
+}
@@ -1,34 +1,187 @@
 #include "Game.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <fstream>
+#include <thread>
 
 #include <SDL.h>
 #include <SDL2/SDL_image.h>
 
+#include "ECS/Systems.hpp"
 #include "Entity/PlayerEntity.hpp"
+#include "Input/InputScript.hpp"
+#include "MPhysac/MPhysacWorld.hpp"
+#include "Utils/AllocTracker.hpp"
+#include "Utils/Metrics.hpp"
+#include "Utils/Profiler.hpp"
+#include "Utils/StartupTimeline.hpp"
 
-Game::Game() :
-	win(),
-	renderer(win),
-	painter(renderer.r),
-	resources(renderer.r),
-	testPlayer(resources),
+namespace {
+	struct GameMetrics {
+		GameMetrics() :
+			events(Metrics::counter("input.events")),
+			frames(Metrics::counter("render.frames")),
+			drawCalls(Metrics::counter("render.draw_calls")),
+			textureSwitches(Metrics::counter("render.texture_switches")),
+			frameDuration(Metrics::histogram("render.frame_us")),
+			tickDuration(Metrics::histogram("update.tick_us"))
+		{}
+
+		Metrics::Counter &events, &frames, &drawCalls, &textureSwitches;
+		Metrics::Histogram &frameDuration, &tickDuration;
+	};
+
+	GameMetrics& metrics() {
+		static GameMetrics instance;
+		return instance;
+	}
+
+	// Ticks between two snapshots of the metrics
+	const unsigned long long MetricsPeriod = 600;
+	// Ticks after which the pools, arrays and arenas reached their size, the hot paths must not allocate anymore
+	const unsigned long long WarmupTicks = 120;
+}
+
+Game::Game(const GameOptions& options) :
+	options(options),
+	win(options.headless ? nullptr : new Window()),
+	renderer(options.headless ? nullptr : new Renderer(*win, options.pacing == FramePacer::VSync)),
+	painter(renderer ? renderer->r : nullptr),
+	resources(renderer ? renderer->r : nullptr),
+	animations(resources),
+	registry(),
+	spawner(registry, animations, Spawner::Capacities{ 2048, 4096, 512 }),
+	world(registry, spawner),
+	testPlayer(registry, resources, animations),
+	camera(Vector2f((float)SCREEN_WIDTH, (float)SCREEN_HEIGHT)),
 	updateFrameDuration(1.f / 60.f),
-	renderFrameDuration(1.f / 144.f)
-{}
+	renderFrameDuration(1.f / 144.f),
+	pacer(options.pacing),
+	prefetchLookahead(256.f),
+	ticks(0),
+	lastDrawCost(0.f)
+{
+	// The first room is read and its images decoded on the prefetcher thread while the rest is initialized.
+	// Rooms are optional until the map is written.
+	const bool hasRooms = (bool)std::ifstream(Room::fileName(0));
+	if (hasRooms)
+		resources.prefetchRoom(0);
+
+	const uint32_t tickMicroseconds = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(updateFrameDuration).count();
+	if (!options.recordFile.empty())
+		recorder.reset(new InputRecorder(options.recordFile, tickMicroseconds));
+	if (!options.replayFile.empty())
+		replayer.reset(new InputReplayer(options.replayFile));
+
+	// The replay is only the same session at the same tick rate
+	if (replayer && replayer->getTickMicroseconds() != tickMicroseconds)
+		std::cerr << "[Warning] Game::Game - " << options.replayFile << " was recorded at " << replayer->getTickMicroseconds()
+			<< " us per tick, the game runs at " << tickMicroseconds << " us" << std::endl;
+
+	// Nothing moves between two updates, rendering faster is wasted power
+	if (options.pacing == FramePacer::PowerSave)
+		renderFrameDuration = updateFrameDuration;
+
+#ifndef NDEBUG
+	// The reloaded frames are read by the animations, which run on the simulation thread once pipelined
+	if (!options.pipelined && !options.headless)
+		resources.setHotReload(true);
+#endif
+
+	if (renderer) {
+		StartupTimeline::Stage stage("PerfOverlay::init");
+		overlay.init(renderer->r);
+	}
+
+	if (!options.captureFile.empty()) {
+		if (renderer) {
+			capture.reset(new RenderCaptureWriter(options.captureFile, SCREEN_WIDTH, SCREEN_HEIGHT));
+			painter.setCapture(capture.get());
+		} else {
+			std::cerr << "[Warning] Game::Game - nothing is rendered when headless, no capture written" << std::endl;
+		}
+	}
+
+	{
+		StartupTimeline::Stage stage("MPhysacWorld::InitPhysics");
+		MPhysacWorld::getInstance().InitPhysics();
+	}
+	ECS::connectHooks(registry, animations);
+
+	if (hasRooms) {
+		StartupTimeline::Stage stage("Game::enterRoom");
+		enterRoom(resources.enterRoom(0), testPlayer.getPosition());
+	}
+
+	if (options.stress) {
+		StartupTimeline::Stage stage("StressScene");
+		const RoomData *room = resources.getCurrentRoom();
+		const SDL_Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+		stress.reset(new StressScene(registry, spawner, resources,
+			options.stressMix.empty() ? StressScene::defaultMix() : StressScene::parseMix(options.stressMix),
+			room ? room->bounds : screen, options.stressBudget));
+	}
+
+	std::cout << "Resources loaded in " << std::chrono::duration<float, std::milli>(resources.getLoadDuration()).count() << " ms ("
+		<< resources.getPackLoadsCount() << " from pack, " << resources.getFileLoadsCount() << " from files), "
+		<< resources.getUsedBytes() / 1024 << " KiB resident" << std::endl;
+}
 
 Game::~Game() {}
 
 // Core of the game loop
-void Game::run() {
+int Game::run() {
 	running = true;
+	FrameArena::bind(&mainArena);
+	MECHA_PROFILE_THREAD("Main");
+
+	if (options.headless)
+		runHeadless();
+	else if (options.pipelined)
+		runPipelined();
+	else
+		runSerial();
+
+	// Quit before the end of the ramp
+	if (stress && !stress->isOver())
+		stress->report(std::cout);
+
+	// The last periodic snapshot, then the final one : the simulation is over, this thread can publish
+	writeMetrics();
+	if (!options.metricsFile.empty()) {
+		Metrics::takeSnapshot(metricsSnapshots.writeBuffer());
+		metricsSnapshots.publish();
+		writeMetrics();
+	}
+	MECHA_PROFILE_DUMP("mechavania.trace.json");
+
+#ifdef MECHA_ALLOC_TRACKER
+	// Gates the soak runs : the steady state must not touch the heap
+	if (options.headless && AllocTracker::getHotPathAllocations())
+		return 2;
+#endif
+
+	return 0;
+}
+
+void Game::runSerial() {
+	typedef std::chrono::steady_clock Clock;
+
 	std::chrono::duration<float> sinceLastUpdate(0.f), sinceLastRender(0.f);
 
-	std::chrono::time_point<std::chrono::steady_clock> lastUpdate(std::chrono::steady_clock::now()), lastRender(std::chrono::steady_clock::now());
+	std::chrono::time_point<Clock> lastUpdate(Clock::now());
 	std::chrono::duration<float> dt(0);
 
+	// With vsync, the presentation paces the rendering and there is no render deadline
+	const bool vsync = pacer.getMode() == FramePacer::VSync;
+
 	while (running) {
-		std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+		mainArena.reset();
+
+		std::chrono::time_point<Clock> now = Clock::now();
 		dt = now - lastUpdate;
 		lastUpdate = now;
 
@@ -39,41 +192,246 @@ void Game::run() {
 			sinceLastUpdate -= updateFrameDuration;
 			
 			processInput();
-			testPlayer.processRealTimeEvents();
+			if (!processPlayerInput(SDL_GetKeyboardState(NULL))) {
+				running = false;
+				break;
+			}
 
 			update(updateFrameDuration);
+			updateRoom(testPlayer.getPosition());
 			updateStats(updateFrameDuration, std::chrono::seconds::zero());
 		}
+		writeMetrics();
 
-		if (sinceLastRender > renderFrameDuration) {
+		if (vsync || sinceLastRender > renderFrameDuration) {
 			updateStats(std::chrono::seconds::zero(), sinceLastRender);
-			draw();
+			draw(sinceLastRender);
 			sinceLastRender = std::chrono::seconds::zero();
+
+			if (vsync)
+				continue;
+		}
+
+		// Sleep until whichever comes first, the next update or the next render
+		const std::chrono::duration<float> untilNext = std::min(updateFrameDuration - sinceLastUpdate, renderFrameDuration - sinceLastRender);
+		pacer.waitUntil(now + std::chrono::duration_cast<Clock::duration>(untilNext));
+	}
+}
+
+void Game::runHeadless() {
+	typedef std::chrono::steady_clock Clock;
+
+	InputScript script;
+	if (!options.inputScript.empty())
+		script.loadFromFile(options.inputScript);
+
+	KeyboardState keyboard;
+	std::memset(keyboard.keys, 0, sizeof(keyboard.keys));
+
+	const std::chrono::time_point<Clock> start(Clock::now());
+
+	unsigned long long tick = 0;
+	for (; running && (stress || tick < options.ticks); tick++) {
+		mainArena.reset();
+
+		if (!script.apply(tick, keyboard.keys))
+			break;
+
+		if (!processPlayerInput(keyboard.keys))
+			break;
+
+		update(updateFrameDuration);
+		updateRoom(testPlayer.getPosition());
+		writeMetrics();
+		endStartup();
+	}
+
+	const std::chrono::duration<float> simulated = updateFrameDuration * (float)tick;
+	const std::chrono::duration<float> elapsed = Clock::now() - start;
+
+	std::cout << "Headless run: " << tick << " ticks (" << simulated.count() << " s of game) in " << elapsed.count() * 1000.f << " ms, x"
+		<< (elapsed.count() > 0.f ? simulated.count() / elapsed.count() : 0.f) << " real time" << std::endl;
+	std::cout << "Player at " << testPlayer.getPosition().x << ", " << testPlayer.getPosition().y << ", "
+		<< registry.size() << " entities, " << MPhysacWorld::getInstance().GetMPhysacBodiesCount() << " physics bodies" << std::endl;
+
+	const WorldManager::Stats worldStats = world.getStats();
+	std::cout << "World: " << worldStats.rooms << " rooms populated, " << worldStats.active << " enemies active, "
+		<< worldStats.nearby << " asleep, " << worldStats.stored << " stored" << std::endl;
+	std::cout << "Frame arena: " << mainArena.takePeak() / 1024 << " KiB peak, " << mainArena.getCapacity() / 1024 << " KiB capacity, "
+		<< mainArena.takeOverflows() << " overflows" << std::endl;
+
+#ifdef MECHA_ALLOC_TRACKER
+	// Whole run, the warm up and the room loads included
+	const AllocTracker::Stats heap = AllocTracker::takeStats();
+	std::cout << "Heap: " << heap.peakLiveBytes / 1024 << " KiB peak live, per tick:";
+	for (int t = 0; t < AllocTracker::TagsCount; t++)
+		std::cout << " " << AllocTracker::tagName((AllocTracker::Tag)t) << " " << (float)heap.allocations[t] / (float)std::max(tick, 1ull)
+			<< " (" << heap.bytes[t] / std::max(tick, 1ull) << " B)";
+	std::cout << std::endl;
+
+	if (heap.hotPathAllocations) {
+		std::cerr << "[Error] Game::runHeadless - " << heap.hotPathAllocations << " allocations on the hot paths after the warm up:" << std::endl;
+		AllocTracker::reportHotPathAllocations(std::cerr);
+	}
+#endif
+}
+
+// The main thread polls the events, streams the rooms and renders the latest tick published by the simulation thread.
+// Only the keyboard state and the render state cross threads, through triple buffers, so that neither side waits for the other.
+// The textures, rooms and SDL calls stay on the main thread.
+void Game::runPipelined() {
+	typedef std::chrono::steady_clock Clock;
+
+	// Published before the simulation starts, so that it never reads an uninitialized state
+	processInput();
+	std::memcpy(keyboardStates.writeBuffer().keys, SDL_GetKeyboardState(NULL), sizeof(KeyboardState::keys));
+	keyboardStates.publish();
+
+	// An exception of the simulation stops both threads, it is rethrown here once the simulation is joined
+	std::exception_ptr simulationError;
+	std::thread simulation([this, &simulationError]() {
+		try {
+			simulate();
+		} catch (...) {
+			simulationError = std::current_exception();
+			running = false;
+		}
+	});
+
+	// Stops and joins the simulation however the loop ends, a joinable thread must not be destroyed by an exception.
+	// The triple buffers never block, the simulation sees running within a tick.
+	struct SimulationJoiner {
+		std::atomic<bool> &running;
+		std::thread &simulation;
+		~SimulationJoiner() { running = false; simulation.join(); }
+	};
+
+	const bool vsync = pacer.getMode() == FramePacer::VSync;
+	std::chrono::time_point<Clock> lastRender(Clock::now());
+	unsigned long long lastTick = 0;
+
+	{
+		SimulationJoiner joiner = { running, simulation };
+		while (running) {
+			mainArena.reset();
+
+			const std::chrono::time_point<Clock> now = Clock::now();
+
+			processInput();
+			std::memcpy(keyboardStates.writeBuffer().keys, SDL_GetKeyboardState(NULL), sizeof(KeyboardState::keys));
+			keyboardStates.publish();
+
+			if (renderStates.fetch()) {
+				const RenderState &state = renderStates.readBuffer();
+				for (; lastTick < state.tick; lastTick++)
+					updateStats(updateFrameDuration, std::chrono::seconds::zero());
+
+				updateRoom(state.playerPosition);
+			}
+			writeMetrics();
+
+			// Nothing to draw until the first tick, the live entities belong to the simulation thread
+			const std::chrono::duration<float> sinceLastRender = now - lastRender;
+			if (lastTick && (vsync || sinceLastRender > renderFrameDuration)) {
+				updateStats(std::chrono::seconds::zero(), sinceLastRender);
+				draw(sinceLastRender, &renderStates.readBuffer());
+				lastRender = now;
+
+				if (vsync)
+					continue;
+			}
+
+			pacer.waitUntil(lastRender + std::chrono::duration_cast<Clock::duration>(renderFrameDuration));
 		}
 	}
+
+	if (simulationError)
+		std::rethrow_exception(simulationError);
+}
+
+// Simulation thread : fixed rate updates, each one recorded into a render state
+void Game::simulate() {
+	typedef std::chrono::steady_clock Clock;
+
+	// The vsync cannot pace this thread
+	FramePacer simulationPacer(pacer.getMode() == FramePacer::VSync ? FramePacer::Sleep : pacer.getMode());
+	Painter recorder(nullptr);
+	FrameArena::bind(&simulationArena);
+	MECHA_PROFILE_THREAD("Simulation");
+
+	std::chrono::time_point<Clock> nextTick(Clock::now());
+	unsigned long long tick = 0;
+
+	while (running) {
+		simulationArena.reset();
+
+		keyboardStates.fetch();
+		if (!processPlayerInput(keyboardStates.readBuffer().keys)) {
+			running = false;
+			break;
+		}
+
+		update(updateFrameDuration);
+
+		RenderState &state = renderStates.writeBuffer();
+		state.clear();
+		state.tick = ++tick;
+		state.playerPosition = testPlayer.getPosition();
+
+		recorder.record(&state);
+		ECS::drawSprites(registry, animations, recorder);
+		renderStates.publish();
+
+		nextTick += std::chrono::duration_cast<Clock::duration>(updateFrameDuration);
+		simulationPacer.waitUntil(nextTick);
+	}
 }
 
 void Game::updateStats(const std::chrono::duration<float> &dtU, const std::chrono::duration<float> &dtR) {
+	// Lines of the overlay refreshed every second
+	enum { RenderLine, UpdateLine, PacingLine, ArenaLine, HeapLine };
+
 	static std::chrono::duration<float> dtRender(0), dtUpdate(0); 
 	static int renderFps = 0, updateFps = 0;
 	
 	dtRender += dtR; dtUpdate += dtU;
 
-	if (dtR.count() != 0)
+	if (dtR.count() != 0) {
 		renderFps++;
+		overlay.addFrame(std::chrono::duration<float, std::milli>(dtR).count());
+	}
 
 	if (dtU.count() != 0)
 		updateFps++;
 
 	if (dtRender > std::chrono::duration<float>(1.f)) {
-		std::cout << "FPS (Render): " << renderFps << std::endl;
+		overlay.setLine(RenderLine, "FPS render %d, %u culled per frame", renderFps, painter.takeCulledCount() / (unsigned int)std::max(renderFps, 1));
 		
 		dtRender -= std::chrono::duration<float>(1.f);
 		renderFps = 0;
 	}
 	
 	if (dtUpdate > std::chrono::duration<float>(1.f)) {
-		std::cout << "FPS (Update): " << updateFps << std::endl;
+		overlay.setLine(UpdateLine, "FPS update %d", updateFps);
+
+		const FramePacer::JitterStats jitter = pacer.takeStats();
+		overlay.setLine(PacingLine, "Pacing %u waits, late %.0f us mean %.0f us max, %d%% asleep",
+			jitter.waits, jitter.meanLateness, jitter.maxLateness, (int)(jitter.sleepRatio * 100.f));
+
+		// Largest frame of the last second, the simulation thread has its own arena once pipelined
+		FrameArena &arena = options.pipelined ? simulationArena : mainArena;
+		overlay.setLine(ArenaLine, "Arena %u KiB peak, %u on the heap", (unsigned int)(arena.takePeak() / 1024), arena.takeOverflows());
+
+#ifdef MECHA_ALLOC_TRACKER
+		const AllocTracker::Stats heap = AllocTracker::takeStats();
+		uint64_t allocations = 0, bytes = 0;
+		for (int t = 0; t < AllocTracker::TagsCount; t++) {
+			allocations += heap.allocations[t];
+			bytes += heap.bytes[t];
+		}
+		overlay.setLine(HeapLine, "Heap %.1f allocs %u B per tick, %u KiB peak, %u on hot paths", (float)allocations / (float)std::max(updateFps, 1),
+			(unsigned int)(bytes / (uint64_t)std::max(updateFps, 1)), (unsigned int)(heap.peakLiveBytes / 1024), (unsigned int)heap.hotPathAllocations);
+#endif
 		
 		dtUpdate -= std::chrono::duration<float>(1.f);
 		updateFps = 0;
@@ -81,16 +439,114 @@ void Game::updateStats(const std::chrono::duration<float> &dtU, const std::chron
 }
 
 void Game::update(const std::chrono::duration<float> &dt) {
-	testPlayer.update(dt);
+	typedef std::chrono::steady_clock Clock;
+	typedef std::chrono::duration<float, std::milli> Milliseconds;
+
+	MECHA_PROFILE_ZONE("Game::update");
+	MECHA_ALLOC_TAG(Gameplay);
+	const Clock::time_point start = Clock::now();
+
+	world.update(dt.count(), testPlayer.getPosition());
+	ECS::updateAI(registry, testPlayer.getPosition());
+
+	MPhysacWorld &physics = MPhysacWorld::getInstance();
+	const Clock::time_point physicsStart = Clock::now();
+	physics.RunPhysicsStep(dt);
+	overlay.addPhase(PerfOverlay::Physics, Milliseconds(Clock::now() - physicsStart).count());
+	overlay.setSimulationCounters((unsigned int)physics.GetMPhysacBodiesCount(), (unsigned int)physics.GetManifoldsCount());
+
+	ECS::integrateMovement(registry, dt.count());
+	ECS::syncPhysics(registry);
+
+	ECS::removeDead(registry);
+	spawner.update(dt.count());
+	animations.update(dt.count());
+
+	const Clock::duration tick = Clock::now() - start;
+	overlay.addPhase(PerfOverlay::Update, Milliseconds(tick).count());
+	metrics().tickDuration.record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(tick).count());
+
+	// Only taken in the tick, the main loop writes it : the file I/O stays out of the measured ticks
+	if (++ticks % MetricsPeriod == 0 && !options.metricsFile.empty()) {
+		Metrics::takeSnapshot(metricsSnapshots.writeBuffer());
+		metricsSnapshots.publish();
+	}
+	if (ticks == WarmupTicks)
+		MECHA_ALLOC_STEADY();
+
+	// Both threads work at the same time once pipelined, the tick is over budget when either is
+	const float drawCost = lastDrawCost;
+	const float tickCost = Milliseconds(tick).count();
+	if (stress && !stress->isOver() && !stress->update(options.pipelined ? std::max(tickCost, drawCost) : tickCost + drawCost)) {
+		stress->report(std::cout);
+		running = false;
+	}
+}
+
+void Game::endStartup() {
+	if (StartupTimeline::isOver())
+		return;
+
+	StartupTimeline::firstFrame();
+	if (options.startupTimeline)
+		StartupTimeline::report(std::cout);
+}
+
+void Game::writeMetrics() {
+	if (metricsSnapshots.fetch() && !Metrics::writeSnapshot(metricsSnapshots.readBuffer(), options.metricsFile))
+		std::cerr << "[Warning] Game::writeMetrics - cannot write " << options.metricsFile << std::endl;
+}
+
+// Prefetches the rooms the player gets close to, and enters the next room once the player left the current one through a door
+void Game::updateRoom(const Vector2f &playerPosition) {
+	const RoomData *room = resources.getCurrentRoom();
+	if (!room)
+		return;
+
+	resources.prefetchNear(playerPosition, prefetchLookahead);
+
+	SDL_Point pos = { (int)playerPosition.x, (int)playerPosition.y };
+	if (SDL_PointInRect(&pos, &room->bounds))
+		return;
+
+	for (auto &door : room->doors) {
+		if (SDL_PointInRect(&pos, &door.area)) {
+			// Entering may unload the room being left (a one way door) : room and door are not used past this point
+			const Room::ID target = door.target;
+			enterRoom(resources.enterRoom(target), playerPosition);
+
+			const ResourcesLoader::PrefetchStats &stats = resources.getPrefetchStats();
+			std::cout << "Entered room " << target << " (prefetch: " << stats.requests << " requests, "
+				<< stats.hits << " hits, " << stats.misses << " misses)" << std::endl;
+			break;
+		}
+	}
+}
+
+void Game::enterRoom(const RoomData &room, const Vector2f &playerPosition) {
+	camera.setRoomBounds(room.bounds, playerPosition);
+
+	// The rooms behind the doors which are not loaded yet get their enemies once entered
+	std::vector<const RoomData*> adjacent;
+	for (auto &door : room.doors)
+		if (const RoomData *next = resources.findRoom(door.target))
+			adjacent.push_back(next);
+
+	world.enterRoom(room, adjacent);
 }
 
 void Game::processInput() {
+	MECHA_PROFILE_ZONE("Game::processInput");
+	MECHA_ALLOC_TAG(Input);
+
 	SDL_Event ev;
 
 	while (SDL_PollEvent(&ev)) {
+		metrics().events.add();
+
 		switch(ev.type) {
 		case SDL_WINDOWEVENT:
-			if (ev.window.windowID == SDL_GetWindowID(win.w)) {
+			if (ev.window.windowID == SDL_GetWindowID(win->w)) {
 				switch (ev.window.event) {
 				case SDL_WINDOWEVENT_FOCUS_GAINED:
 					std::cout << "Gained Focus" << std::endl;
@@ -106,6 +562,12 @@ void Game::processInput() {
 		case SDL_KEYDOWN:
 			if (ev.key.keysym.scancode == SDL_SCANCODE_ESCAPE)
 				running = false;
+			if (ev.key.keysym.scancode == SDL_SCANCODE_F3 && !ev.key.repeat)
+				overlay.toggle();
+#ifdef MECHA_PROFILER
+			if (ev.key.keysym.scancode == SDL_SCANCODE_F12 && !ev.key.repeat && MECHA_PROFILE_DUMP("mechavania.trace.json"))
+				std::cout << "Trace written to mechavania.trace.json" << std::endl;
+#endif
 			break;
 		case SDL_QUIT:
 			running = false;
@@ -113,15 +575,77 @@ void Game::processInput() {
 		default:
 			break;
 		}
+
+		// The player is owned by the simulation thread once pipelined, it only uses the keyboard state there
+		if (!options.pipelined && !replayer)
+			testPlayer.processEvent(ev);
 	}
-	testPlayer.processEvent(ev);
 }
 
-void Game::draw() {
-	SDL_RenderClear(renderer.r);
+bool Game::processPlayerInput(const Uint8 *kbState) {
+	MECHA_ALLOC_TAG(Input);
+	MECHA_ALLOC_HOT_PATH("Game::processPlayerInput");
+
+	if (replayer) {
+		ActionState state;
+		if (!replayer->next(state))
+			return false;
+
+		testPlayer.processActionState(state);
+	} else {
+		testPlayer.processRealTimeEvents(kbState);
+	}
+
+	if (recorder)
+		recorder->record(testPlayer.getActionState());
+
+	return true;
+}
+
+void Game::draw(const std::chrono::duration<float> &dt, const RenderState *snapshot) {
+	typedef std::chrono::steady_clock Clock;
+
+	MECHA_PROFILE_ZONE("Game::draw");
+	MECHA_ALLOC_TAG(Render);
+	const Clock::time_point start = Clock::now();
+
+	// Upload what the prefetcher decoded, one image per frame
+	resources.update();
+
+	// Moved per rendered frame rather than per tick, so that it scrolls smoothly at any render rate
+	camera.update(dt.count(), snapshot ? snapshot->playerPosition : testPlayer.getPosition());
+	painter.setView(camera.getView());
+
+	SDL_RenderClear(renderer->r);
+
+	if (snapshot)
+		painter.submit(*snapshot, resources);
+	else
+		ECS::drawSprites(registry, animations, painter);
+
+	if (capture) {
+		capture->endFrame();
+		if (capture->getFramesCount() >= options.captureFrames) {
+			painter.setCapture(nullptr);
+			capture.reset();
+			std::cout << "Render capture of " << options.captureFrames << " frames written to " << options.captureFile << std::endl;
+		}
+	}
+
+	const unsigned int drawCalls = painter.takeDrawCallsCount();
+	overlay.setRenderCounters(drawCalls, resources.getUsedBytes());
+	overlay.draw(painter);
 
-	// Draw something
-	painter.draw(testPlayer);
+	// Before the present, which may wait for the vertical blank
+	const Clock::duration frame = Clock::now() - start;
+	lastDrawCost = std::chrono::duration<float, std::milli>(frame).count();
+	overlay.addPhase(PerfOverlay::Render, lastDrawCost);
+	metrics().frames.add();
+	metrics().drawCalls.add(drawCalls);
+	metrics().textureSwitches.add(painter.takeTextureSwitchesCount());
+	metrics().frameDuration.record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(frame).count());
 
-	SDL_RenderPresent(renderer.r);
+	SDL_RenderPresent(renderer->r);
+	resources.nextFrame();
+	endStartup();
 }
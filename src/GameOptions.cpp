@@ -0,0 +1,97 @@
+#include "GameOptions.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// Returns true and sets value if arg is "<name>=<value>"
+	bool matchOption(const std::string& arg, const std::string& name, std::string& value) {
+		if (arg.compare(0, name.size(), name) != 0 || arg.size() <= name.size() || arg[name.size()] != '=')
+			return false;
+
+		value = arg.substr(name.size() + 1);
+		return true;
+	}
+
+	unsigned long long toCount(const std::string& arg, const std::string& value) {
+		std::istringstream in(value);
+		unsigned long long count;
+
+		if (!(in >> count) || !in.eof())
+			throw std::runtime_error("[Error] GameOptions::parse - expected a number in " + arg);
+
+		return count;
+	}
+
+	float toFloat(const std::string& arg, const std::string& value) {
+		std::istringstream in(value);
+		float number;
+
+		if (!(in >> number) || !in.eof())
+			throw std::runtime_error("[Error] GameOptions::parse - expected a number in " + arg);
+
+		return number;
+	}
+}
+
+GameOptions::GameOptions() :
+	pacing(FramePacer::Sleep),
+	pipelined(false),
+#ifdef MECHA_HEADLESS
+	headless(true),
+#else
+	headless(false),
+#endif
+	ticks(60 * 60), // One minute of game
+	stress(false),
+	stressBudget(1000.f / 60.f),
+	captureFrames(600),
+	startupTimeline(false)
+{}
+
+GameOptions GameOptions::parse(int argc, char** argv) {
+	GameOptions options;
+	std::string value;
+
+	for (int i = 1; i < argc; i++) {
+		const std::string arg(argv[i]);
+
+		if (matchOption(arg, "--pacing", value))
+			options.pacing = FramePacer::modeFromName(value);
+		else if (arg == "--pipeline")
+			options.pipelined = true;
+		else if (arg == "--headless")
+			options.headless = true;
+		else if (matchOption(arg, "--ticks", value))
+			options.ticks = toCount(arg, value);
+		else if (matchOption(arg, "--script", value))
+			options.inputScript = value;
+		else if (matchOption(arg, "--record", value))
+			options.recordFile = value;
+		else if (matchOption(arg, "--replay", value))
+			options.replayFile = value;
+		else if (matchOption(arg, "--metrics", value))
+			options.metricsFile = value;
+		else if (arg == "--stress")
+			options.stress = true;
+		else if (matchOption(arg, "--stress", value)) {
+			options.stress = true;
+			options.stressMix = value;
+		} else if (matchOption(arg, "--stress-budget", value))
+			options.stressBudget = toFloat(arg, value);
+		else if (matchOption(arg, "--capture", value))
+			options.captureFile = value;
+		else if (matchOption(arg, "--capture-frames", value))
+			options.captureFrames = toCount(arg, value);
+		else if (arg == "--startup-timeline")
+			options.startupTimeline = true;
+		else
+			throw std::runtime_error("[Error] GameOptions::parse - unknown argument " + arg);
+	}
+
+	if (!options.inputScript.empty() && !options.replayFile.empty())
+		throw std::runtime_error("[Error] GameOptions::parse - --script and --replay both drive the player");
+
+	return options;
+}
@@ -0,0 +1,138 @@
+#include "Input/InputLog.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+	const char Magic[4] = { 'M', 'V', 'I', 'R' };
+	const unsigned char Version = 1;
+}
+
+InputRecorder::InputRecorder(const std::string& filename, uint32_t tickMicroseconds) :
+	file(filename, std::ios::binary | std::ios::trunc),
+	tick(0),
+	lastRecord(0),
+	previousDown(0)
+{
+	if (!file)
+		throw std::runtime_error("[Error] InputRecorder::InputRecorder - failed to create " + filename);
+
+	file.write(Magic, sizeof(Magic));
+	file.put((char)Version);
+	writeVarint(tickMicroseconds);
+}
+
+InputRecorder::~InputRecorder() {
+	// The end marker : the replay stops after the last recorded tick
+	writeVarint(tick - lastRecord);
+	writeVarint(0);
+	writeVarint(0);
+}
+
+void InputRecorder::record(const ActionState& state) {
+	tick++;
+
+	const uint32_t changed = state.down ^ previousDown;
+	const uint32_t taps = state.pressed & state.released;
+	if (!changed && !taps)
+		return;
+
+	writeVarint(tick - lastRecord);
+	writeVarint(changed);
+	writeVarint(taps);
+
+	lastRecord = tick;
+	previousDown = state.down;
+}
+
+void InputRecorder::writeVarint(uint64_t value) {
+	do {
+		unsigned char byte = value & 0x7F;
+		value >>= 7;
+		if (value)
+			byte |= 0x80;
+		file.put((char)byte);
+	} while (value);
+}
+
+InputReplayer::InputReplayer(const std::string& filename) :
+	filename(filename),
+	offset(0),
+	tickMicroseconds(0),
+	tick(0),
+	nextRecord(0),
+	down(0),
+	nextXor(0),
+	nextTaps(0),
+	ended(false)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+		throw std::runtime_error("[Error] InputReplayer::InputReplayer - failed to open " + filename);
+
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	if (data.size() < sizeof(Magic) + 1 || !std::equal(Magic, Magic + sizeof(Magic), data.begin()))
+		throw std::runtime_error("[Error] InputReplayer::InputReplayer - " + filename + " is not an input log");
+	if (data[sizeof(Magic)] != Version)
+		throw std::runtime_error("[Error] InputReplayer::InputReplayer - unsupported version of " + filename);
+
+	offset = sizeof(Magic) + 1;
+	tickMicroseconds = (uint32_t)readVarint();
+
+	readRecord();
+}
+
+bool InputReplayer::next(ActionState& state) {
+	if (ended)
+		return false;
+
+	tick++;
+	if (tick > nextRecord) {
+		ended = true;
+		return false;
+	}
+
+	uint32_t changed = 0, taps = 0;
+	if (tick == nextRecord) {
+		changed = nextXor;
+		taps = nextTaps;
+
+		// The end marker has empty masks, the log is over after its tick
+		if (changed || taps)
+			readRecord();
+		else
+			ended = true;
+	}
+
+	down ^= changed;
+
+	state.down = down;
+	state.pressed = (changed & down) | taps;
+	state.released = (changed & ~down) | taps;
+
+	return true;
+}
+
+uint64_t InputReplayer::readVarint() {
+	uint64_t value = 0;
+
+	for (unsigned int shift = 0; shift < 64; shift += 7) {
+		if (offset >= data.size())
+			throw std::runtime_error("[Error] InputReplayer::readVarint - " + filename + " is truncated");
+
+		const unsigned char byte = data[offset++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+
+	throw std::runtime_error("[Error] InputReplayer::readVarint - malformed number in " + filename);
+}
+
+void InputReplayer::readRecord() {
+	nextRecord += readVarint();
+	nextXor = (uint32_t)readVarint();
+	nextTaps = (uint32_t)readVarint();
+}
@@ -0,0 +1,70 @@
+#include "Input/InputScript.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+void InputScript::loadFromFile(const std::string& filename) {
+	std::ifstream file(filename);
+	if (!file)
+		throw std::runtime_error("[Error] InputScript::loadFromFile - failed to open " + filename);
+
+	commands.clear();
+	next = 0;
+
+	std::string line;
+	for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+		std::istringstream in(line);
+		std::string first;
+
+		if (!(in >> first) || first[0] == '#')
+			continue;
+
+		Command command;
+		std::string type, key;
+		std::istringstream tick(first);
+
+		if (!(tick >> command.tick) || !(in >> type))
+			throw std::runtime_error("[Error] InputScript::loadFromFile - malformed line " + filename + ":" + std::to_string(lineNumber));
+
+		if (type == "quit") {
+			command.type = Command::Quit;
+			command.key = SDL_SCANCODE_UNKNOWN;
+		} else if (type == "press" || type == "release") {
+			command.type = type == "press" ? Command::Press : Command::Release;
+
+			// Scancode names may contain spaces (Left Shift...)
+			std::getline(in >> std::ws, key);
+			command.key = SDL_GetScancodeFromName(key.c_str());
+			if (command.key == SDL_SCANCODE_UNKNOWN)
+				throw std::runtime_error("[Error] InputScript::loadFromFile - unknown key " + key + " in " + filename + ":" + std::to_string(lineNumber));
+		} else {
+			throw std::runtime_error("[Error] InputScript::loadFromFile - unknown command " + type + " in " + filename + ":" + std::to_string(lineNumber));
+		}
+
+		commands.push_back(command);
+	}
+
+	// Commands of a same tick keep their order
+	std::stable_sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) { return a.tick < b.tick; });
+}
+
+bool InputScript::apply(unsigned long long tick, Uint8* keys) {
+	for (; next < commands.size() && commands[next].tick <= tick; ++next) {
+		const Command &command = commands[next];
+
+		switch (command.type) {
+		case Command::Press:
+			keys[command.key] = 1;
+			break;
+		case Command::Release:
+			keys[command.key] = 0;
+			break;
+		case Command::Quit:
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -7,30 +7,124 @@
 
 #include "MCamera/MCamera.hpp"
 
-void MCamera::update() {
-    // if(this->followedPhysicsBody != nullptr) {
-    //     this->camera.target = (Vector2){(this->followedPhysicsBody)->position.x, (this->followedPhysicsBody)->position.y}; // TODO : the camera is not centered on the entity for now
-    // } else {
-    //     this->camera.target = (Vector2){(this->cameraPhysicsBody)->position.x, (this->cameraPhysicsBody)->position.y};
-    // }
+#include <algorithm>
+
+MCamera::MCamera(const Vector2f &viewSize) :
+    size(viewSize),
+    center(viewSize * 0.5f),
+    hasRoom(false),
+    room({ 0, 0, 0, 0 }),
+    deadZone(48.f, 32.f),
+    transitionDuration(0.5f),
+    panned(false),
+    returning(false)
+{
+    transition.active = false;
+    transition.elapsed = transition.duration = 0.f;
+    updateView();
+}
+
+void MCamera::update(float dt, const Vector2f &target) {
+    if (transition.active) {
+        // A return to the target chases it rather than where it was when follow() was called
+        if (returning)
+            transition.to = followCenter(target);
+
+        transition.elapsed += dt;
+        const float t = transition.duration > 0.f ? std::min(transition.elapsed / transition.duration, 1.f) : 1.f;
+        const float s = t * t * (3.f - 2.f * t);    // Smoothstep : no jolt at both ends
+
+        center = transition.from + (transition.to - transition.from) * s;
+        if (t >= 1.f)
+            transition.active = returning = false;
+    } else if (!panned) {
+        center = followCenter(target);
+    }
+
+    updateView();
+}
+
+void MCamera::setRoomBounds(const SDL_Rect &bounds, const Vector2f &target) {
+    const bool first = !hasRoom;
+
+    hasRoom = true;
+    room = bounds;
+
+    if (panned)
+        return;
+
+    if (first) {
+        center = clamp(target);
+        updateView();
+    } else {
+        returning = false;
+        // The view centered on the target along the axes it has room to, like the follow would end up after the transition
+        startTransition(clamp(target), transitionDuration);
+    }
+}
+
+void MCamera::panTo(const Vector2f &c, float duration) {
+    panned = true;
+    returning = false;
+    startTransition(clamp(c), duration);
 }
 
-void MCamera::setFollowedPhysicsBody(MPhysacBody* body) {
-    this->followedPhysicsBody = body;
-    this->update();
+void MCamera::follow(float duration) {
+    if (!panned)
+        return;
+
+    panned = false;
+    returning = true;
+    startTransition(center, duration);
 }
 
-// Camera2D& MCamera::getCamera(){
-//     return this->camera;
-// }
+Vector2f MCamera::followCenter(const Vector2f &target) const {
+    Vector2f desired(center);
+
+    if (target.x > center.x + deadZone.x)
+        desired.x = target.x - deadZone.x;
+    else if (target.x < center.x - deadZone.x)
+        desired.x = target.x + deadZone.x;
+
+    if (target.y > center.y + deadZone.y)
+        desired.y = target.y - deadZone.y;
+    else if (target.y < center.y - deadZone.y)
+        desired.y = target.y + deadZone.y;
+
+    return clamp(desired);
+}
+
+// Keeps the view inside the room along each axis, a room smaller than the screen being centered
+Vector2f MCamera::clamp(const Vector2f &c) const {
+    if (!hasRoom)
+        return c;
+
+    Vector2f res(c);
 
-MCamera::MCamera() {
-    // this->camera = {0};
-    // this->camera.offset = (Vector2){ SCREEN_WIDTH/2, SCREEN_WIDTH/2 };
-    // this->camera.target = (Vector2){ SCREEN_WIDTH/2, SCREEN_WIDTH/2 };
-    // this->camera.rotation = 0.0f;
-    // this->camera.zoom = 1.0f;
+    if ((float)room.w <= size.x)
+        res.x = (float)room.x + (float)room.w * 0.5f;
+    else
+        res.x = std::max((float)room.x + size.x * 0.5f, std::min(res.x, (float)(room.x + room.w) - size.x * 0.5f));
 
-    // this->cameraPhysicsBody = glMPhysac->CreatePhysicsBodyRectangle(camera.target, 1, 1, 1);
-    this->followedPhysicsBody = nullptr;
-}
\ No newline at end of file
+    if ((float)room.h <= size.y)
+        res.y = (float)room.y + (float)room.h * 0.5f;
+    else
+        res.y = std::max((float)room.y + size.y * 0.5f, std::min(res.y, (float)(room.y + room.h) - size.y * 0.5f));
+
+    return res;
+}
+
+void MCamera::startTransition(const Vector2f &to, float duration) {
+    transition.active = true;
+    transition.from = center;
+    transition.to = to;
+    transition.elapsed = 0.f;
+    transition.duration = duration;
+}
+
+void MCamera::updateView() {
+    view.x = (int)(center.x - size.x * 0.5f);
+    view.y = (int)(center.y - size.y * 0.5f);
+    view.w = (int)size.x;
+    view.h = (int)size.y;
+}
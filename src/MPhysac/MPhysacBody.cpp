@@ -55,9 +55,9 @@ MPhysacBody::MPhysacBody(const Vector2f& pos, MPhysacShapeType type, const Vecto
     shape.transform = MPhysac::Mat2Radians(0.0f);
 
     switch(type) {
-        case MPHYSAC_BOX: shape.vertexData.CreateRectanglePolygon(pos, dim); break; // TODO : segfault here
-        // case MPHYSAC_POLYGON: shape.vertexData.CreateRandomPolygon(dim.x, dim.y); break; Strange call to Random Polygon here
-        // case MPHYSAC_CIRCLE: shape.vertexData.CreateRandomPolygon(dim.x, dim.y); break;Strange call to Random Polygon here
+        case MPHYSAC_BOX: shape.vertexData.CreateRectanglePolygon(pos, dim); break;         // dim : width and height
+        case MPHYSAC_POLYGON: shape.vertexData.CreateRandomPolygon(dim.x, (int)dim.y); break; // dim : radius and sides count
+        case MPHYSAC_CIRCLE: shape.radius = dim.x; break;                                   // dim : radius, no vertices
         default: break;
     }
 
@@ -86,6 +86,12 @@ MPhysacBody::MPhysacBody(const Vector2f& pos, MPhysacShapeType type, const Vecto
         inertia += (0.25f*PHYSAC_K*D)*(intx2 + inty2);
     }
 
+    // Disc : no vertices, same formulas as the polygons once multiplied by the density below
+    if (type == MPHYSAC_CIRCLE) {
+        area = PHYSAC_PI*shape.radius*shape.radius;
+        inertia = area*shape.radius*shape.radius;
+    }
+
     center.x *= 1.0f/area;
     center.y *= 1.0f/area;
 
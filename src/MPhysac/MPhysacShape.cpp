@@ -9,7 +9,7 @@
 
 #include "MPhysac/MPhysacShape.hpp"
 
-// Creates a random polygon shape with max vertex distance from polygon pivot
+// Creates a regular polygon shape, its vertices evenly spread on the circle of the given radius around the pivot
 void PolygonData::CreateRandomPolygon(float radius, int sides) {
     // Calculate polygon vertices positions
     for (int i = 0; i < sides; i++) {
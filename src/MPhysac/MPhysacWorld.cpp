@@ -6,14 +6,34 @@
 ********************************************************************************************/
 
 #include "MPhysac/MPhysacWorld.hpp"
+#include "Utils/AllocTracker.hpp"
+#include "Utils/Profiler.hpp"
+#include "Utils/StartupTimeline.hpp"
+
+MPhysacWorld::MPhysacWorld() :
+    bodyPool(PHYSAC_MAX_BODIES),
+    bodyPositions(PHYSAC_MAX_BODIES, 0),
+    stepsMetric(Metrics::counter("physics.steps")),
+    pairsTestedMetric(Metrics::counter("physics.pairs_tested")),
+    manifoldsCreatedMetric(Metrics::counter("physics.manifolds_created")),
+    solverIterationsMetric(Metrics::counter("physics.solver_iterations")),
+    bodiesMetric(Metrics::gauge("physics.bodies")),
+    manifoldsMetric(Metrics::gauge("physics.manifolds")),
+    usedMemoryMetric(Metrics::gauge("physics.memory_bytes")),
+    stepDurationMetric(Metrics::histogram("physics.step_us")) {
+    StartupTimeline::Stage stage("MPhysacWorld");
+
+    // Reserved once and for all, so that the physics step never allocates (about 2.5 MB, a tenth of a millisecond)
+    bodies.reserve(PHYSAC_MAX_BODIES);
+    contacts.reserve(PHYSAC_MAX_MANIFOLDS);
+    UpdateUsedMemory();
+}
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition
 //----------------------------------------------------------------------------------
 // Initializes physics values, pointers and creates physics loop thread
 void MPhysacWorld::InitPhysics() {
-    printf("init physics");
-
     #ifndef PHYSAC_NO_THREADS
         // NOTE: if defined, user will need to create a thread for PhysicsThread function manually
         // Create physics thread using POSIXS thread libraries
@@ -22,18 +42,13 @@ void MPhysacWorld::InitPhysics() {
         printf("thread created")
     #endif
 
-    // Initialize high resolution timer
-    printf("init physics2");
-
     #ifdef PHYSAC_DEBUG
         TRACELOG("[PHYSAC] physics module initialized successfully\n");
     #endif
 
-    printf("init physics3");
-
+    // The arrays are already reserved by the constructor, ResetPhysics keeps their capacity
     accumulator = std::chrono::duration<float>::zero();
-    bodies.reserve(PHYSAC_MAX_BODIES);
-    contacts.reserve(PHYSAC_MAX_MANIFOLDS);
+    UpdateUsedMemory();
 }
 
 // Returns true if physics thread is currently enabled
@@ -49,26 +64,35 @@ void MPhysacWorld::SetPhysicsGravity(float x, float y) {
 
 // Creates a new rectangle physics body with generic parameters
 MPhysacBody* MPhysacWorld::CreatePhysicsBodyRectangle(const Vector2f& pos, float width, float height, float density) {
-    MPhysacBody* newBody = new MPhysacBody(pos, MPHYSAC_BOX, Vector2f(width, height), density);
-
-    // Add new body to bodies pointers array and update bodies count
-    bodies.push_back(newBody);
-
-    return newBody;
+    return AddPhysicsBody(pos, MPHYSAC_BOX, Vector2f(width, height), density);
 }
 
 // Creates a new circle physics body with generic parameters
 MPhysacBody* MPhysacWorld::CreatePhysicsBodyCircle(const Vector2f& pos, float radius, float density)
 {
-    return CreatePhysicsBodyPolygon(pos, radius, PHYSAC_CIRCLE_VERTICES, density);
+    return AddPhysicsBody(pos, MPHYSAC_CIRCLE, Vector2f(radius, 0.f), density);
 }
 
 // Creates a new polygon physics body with generic parameters
 MPhysacBody* MPhysacWorld::CreatePhysicsBodyPolygon(const Vector2f& pos, float radius, int sides, float density)
 {
-    MPhysacBody* newBody = new MPhysacBody(pos, MPHYSAC_POLYGON, Vector2f(radius, (float)sides), density);
+    // The vertices are stored inline, up to PHYSAC_MAX_VERTICES
+    sides = (sides < 3) ? 3 : ((sides > PHYSAC_MAX_VERTICES) ? PHYSAC_MAX_VERTICES : sides);
+
+    return AddPhysicsBody(pos, MPHYSAC_POLYGON, Vector2f(radius, (float)sides), density);
+}
 
-    // Add new body to bodies pointers array and update bodies count
+// Constructs a body in the pool and adds it to the bodies pointers array, nullptr if the pool is full
+MPhysacBody* MPhysacWorld::AddPhysicsBody(const Vector2f& pos, MPhysacShapeType type, const Vector2f& dim, float density) {
+    MPhysacBody* newBody = bodyPool.get(bodyPool.create(pos, type, dim, density));
+    if (newBody == nullptr) {
+        #ifdef PHYSAC_DEBUG
+            TRACELOG("[PHYSAC] physics body creation failed, the pool of %i bodies is full\n", PHYSAC_MAX_BODIES);
+        #endif
+        return nullptr;
+    }
+
+    bodyPositions[bodyPool.handleOf(newBody).index] = (uint32_t)bodies.size();
     bodies.push_back(newBody);
 
     return newBody;
@@ -84,6 +108,31 @@ size_t MPhysacWorld::GetManifoldsCount() {
     return contacts.size();
 }
 
+// Returns the number of physics steps run since the physics were initialized
+unsigned int MPhysacWorld::GetStepsCount() {
+    return stepsCount;
+}
+
+// Returns the number of body pairs which went through the collision detection, over all the steps
+unsigned long long MPhysacWorld::GetPairsTestedCount() {
+    return pairsTestedCount;
+}
+
+// Returns the number of manifolds kept for the pairs in contact, over all the steps
+unsigned long long MPhysacWorld::GetManifoldsCreatedCount() {
+    return manifoldsCreatedCount;
+}
+
+// Returns the number of impulses applied to the manifolds (iterations times manifolds), over all the steps
+unsigned long long MPhysacWorld::GetSolverIterationsCount() {
+    return solverIterationsCount;
+}
+
+// Returns the bytes reserved by the bodies pool, the bodies pointers and the manifolds, as of the last step
+size_t MPhysacWorld::GetUsedMemory() {
+    return usedMemory;
+}
+
 // Returns a MPhysacBody of the bodies pool at a specific index
 MPhysacBody* MPhysacWorld::GetMPhysacBody(int index)
 {
@@ -92,30 +141,23 @@ MPhysacBody* MPhysacWorld::GetMPhysacBody(int index)
 
 // Remove MPhysacBody from bodies list then destroys it 
 void MPhysacWorld::DestroyMPhysacBody(MPhysacBody* body) {
-    for (int i = 0; i < bodies.size(); i++) {
-        if (bodies.at(i) == body) {
-            bodies.at(i) = bodies.back();
-            bodies.pop_back();
-            break;
-        }
-    }
+    // The last body fills the hole
+    const uint32_t position = bodyPositions[bodyPool.handleOf(body).index];
+    bodies[position] = bodies.back();
+    bodyPositions[bodyPool.handleOf(bodies[position]).index] = position;
+    bodies.pop_back();
 
-    delete body;
+    bodyPool.destroy(body);
 }
 
 // Destroys created physics bodies and manifolds and resets global values
 void MPhysacWorld::ResetPhysics() {
     // Delete all MPhysacBodies and empty the list
-    while(bodies.size() > 0) {
-        delete bodies.back();
-        bodies.pop_back();
-    }
+    bodies.clear();
+    bodyPool.clear();
 
-    // Delete all MPhysacManifolds and empty the list
-    while(contacts.size() > 0) {
-        delete contacts.back();
-        contacts.pop_back();
-    }
+    // Empty the MPhysacManifolds list
+    contacts.clear();
 }
 
 // Unitializes physics pointers and exits physics loop thread
@@ -162,78 +204,117 @@ void *MPhysacWorld::PhysicsLoop(void* arg) {
 
 // Physics steps calculations (dynamics, collisions and position corrections)
 void MPhysacWorld::PhysicsStep() {
+    MECHA_PROFILE_ZONE("PhysicsStep");
+    MECHA_ALLOC_HOT_PATH("PhysicsStep");
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
     // Update current steps count
     stepsCount++;
+    const unsigned long long pairsTestedBefore = pairsTestedCount;
     
-    // Clear previous generated collisions information
-    for (int i = contacts.size() - 1; i >= 0; i--) {
-        DestroyPhysicsManifold(contacts.at(i));
-    }
+    // Clear previous generated collisions information (the storage is kept)
+    contacts.clear();
     
     // Reset physics bodies grounded state
     for (size_t i = 0; i < bodies.size(); i++) {
         bodies.at(i)->isGrounded = false;
     }
     
-    // Generate new collision information
-    for (size_t i = 0; i < bodies.size(); i++) {
-        MPhysacBody *bodyA = bodies.at(i);
-
-        for (size_t j = i + 1; j < bodies.size(); j++) {
-            MPhysacBody *bodyB = bodies.at(j);
-
-            if ((bodyA->inverseMass == 0) && (bodyB->inverseMass == 0)) continue;
-            if ((bodyA->solidType == MPHYSAC_NONPASSABLE) && (bodyB->solidType == MPHYSAC_PASSABLE)) continue;
-            if ((bodyA->solidType == MPHYSAC_PASSABLE) && (bodyB->solidType == MPHYSAC_NONPASSABLE)) continue;
-
-            PhysicsManifold *manifold = CreatePhysicsManifold(bodyA, bodyB);
-            SolvePhysicsManifold(manifold);
-
-            if (manifold->contactsCount > 0) {
-                // Create a new manifold with same information as previously solved manifold and add it to the manifolds pool last slot
-                PhysicsManifold *newManifold = CreatePhysicsManifold(bodyA, bodyB);
-                newManifold->penetration = manifold->penetration;
-                newManifold->normal = manifold->normal;
-                newManifold->contacts[0] = manifold->contacts[0];
-                newManifold->contacts[1] = manifold->contacts[1];
-                newManifold->contactsCount = manifold->contactsCount;
-                newManifold->restitution = manifold->restitution;
-                newManifold->dynamicFriction = manifold->dynamicFriction;
-                newManifold->staticFriction = manifold->staticFriction;
+    // Generate new collision information : every pair is tested, the broadphase being only the filters below
+    {
+        MECHA_PROFILE_ZONE("Physics.Collisions");
+
+        for (size_t i = 0; i < bodies.size(); i++) {
+            MPhysacBody *bodyA = bodies.at(i);
+
+            for (size_t j = i + 1; j < bodies.size(); j++) {
+                MPhysacBody *bodyB = bodies.at(j);
+
+                if ((bodyA->inverseMass == 0) && (bodyB->inverseMass == 0)) continue;
+                if ((bodyA->solidType == MPHYSAC_NONPASSABLE) && (bodyB->solidType == MPHYSAC_PASSABLE)) continue;
+                if ((bodyA->solidType == MPHYSAC_PASSABLE) && (bodyB->solidType == MPHYSAC_NONPASSABLE)) continue;
+
+                // Solved on the stack, only the pairs in contact are kept
+                PhysicsManifold manifold(bodyA, bodyB);
+                SolvePhysicsManifold(&manifold);
+                pairsTestedCount++;
+
+                if (manifold.contactsCount > 0) {
+                    contacts.push_back(manifold);
+                    manifoldsCreatedCount++;
+                }
             }
         }
     }
     
     // Integrate forces to physics bodies
-    for (size_t i = 0; i < bodies.size(); i++)
-        IntegratePhysicsForces(bodies.at(i));
+    {
+        MECHA_PROFILE_ZONE("Physics.IntegrateForces");
+
+        for (size_t i = 0; i < bodies.size(); i++)
+            IntegratePhysicsForces(bodies.at(i));
+    }
     
-    // Initialize physics manifolds to solve collisions
-    for (size_t i = 0; i < contacts.size(); i++)
-        InitializePhysicsManifolds(contacts.at(i));
-   
-    // Integrate physics collisions impulses to solve collisions
-    for (size_t i = 0; i < PHYSAC_COLLISION_ITERATIONS; i++)
-        for (int j = 0; j < contacts.size(); j++)
-            IntegratePhysicsImpulses(contacts.at(j));
+    {
+        MECHA_PROFILE_ZONE("Physics.Solve");
+
+        // Initialize physics manifolds to solve collisions
+        for (size_t i = 0; i < contacts.size(); i++)
+            InitializePhysicsManifolds(&contacts[i]);
+
+        // Integrate physics collisions impulses to solve collisions
+        for (size_t i = 0; i < PHYSAC_COLLISION_ITERATIONS; i++)
+            for (int j = 0; j < contacts.size(); j++)
+                IntegratePhysicsImpulses(&contacts[j]);
+    }
         
     // Integrate velocity to physics bodies
-    for (size_t i = 0; i < bodies.size(); i++)
-        IntegratePhysicsVelocity(bodies.at(i));
+    {
+        MECHA_PROFILE_ZONE("Physics.IntegrateVelocity");
+
+        for (size_t i = 0; i < bodies.size(); i++)
+            IntegratePhysicsVelocity(bodies.at(i));
+    }
     
     // Correct physics bodies positions based on manifolds collision information
-    for (size_t i = 0; i < contacts.size(); i++)
-        CorrectPhysicsPositions(contacts.at(i));
+    {
+        MECHA_PROFILE_ZONE("Physics.Correct");
+
+        for (size_t i = 0; i < contacts.size(); i++)
+            CorrectPhysicsPositions(&contacts[i]);
+    }
         
     // Clear physics bodies forces
     for (int i = 0; i < bodies.size(); i++) {
         bodies.at(i)->force = PHYSAC_VECTOR_ZERO;
         bodies.at(i)->torque = 0.0f;
     }
+
+    // The contacts array is the only storage growing with the scene
+    solverIterationsCount += PHYSAC_COLLISION_ITERATIONS * contacts.size();
+    UpdateUsedMemory();
+
+    stepsMetric.add();
+    pairsTestedMetric.add(pairsTestedCount - pairsTestedBefore);
+    manifoldsCreatedMetric.add(contacts.size());
+    solverIterationsMetric.add(PHYSAC_COLLISION_ITERATIONS * contacts.size());
+    bodiesMetric.set((int64_t)bodies.size());
+    manifoldsMetric.set((int64_t)contacts.size());
+    usedMemoryMetric.set((int64_t)usedMemory);
+    stepDurationMetric.record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void MPhysacWorld::UpdateUsedMemory() {
+    usedMemory = bodyPool.memoryUsage()
+        + bodies.capacity() * sizeof(MPhysacBody*)
+        + bodyPositions.capacity() * sizeof(uint32_t)
+        + contacts.capacity() * sizeof(PhysicsManifold);
 }
 
 // Wrapper to ensure PhysicsStep is run with at a fixed time step
 void MPhysacWorld::RunPhysicsStep(const std::chrono::duration<float>& dt) {
+    MECHA_ALLOC_TAG(Physics);
+
     // Store the time elapsed since the last frame began
     accumulator += dt;
 
@@ -252,29 +333,6 @@ void MPhysacWorld::SetPhysicsTimeStep(const std::chrono::duration<float>& delta)
     deltaTime = delta;
 }
 
-// Creates a new physics manifold to solve collision
-PhysicsManifold* MPhysacWorld::CreatePhysicsManifold(MPhysacBody* a, MPhysacBody* b) {
-    PhysicsManifold *newManifold = new PhysicsManifold(a, b);
-
-    // Add new body to bodies pointers array and update bodies count
-    contacts.push_back(newManifold);
-
-    return newManifold;
-}
-
-// Unitializes and destroys a physics manifold
-void MPhysacWorld::DestroyPhysicsManifold(PhysicsManifold* manifold) {
-    for (size_t i = 0; i < contacts.size(); i++) {
-        if (contacts.at(i) == manifold) {
-            contacts.at(i) = contacts.back();
-            contacts.pop_back();
-            break;
-        }
-    }
-
-    delete manifold;
-}
-
 // Solves a created physics manifold between two physics bodies
 void MPhysacWorld::SolvePhysicsManifold(PhysicsManifold* manifold) {
     switch (manifold->bodyA->shape.type) {
@@ -356,7 +414,7 @@ void MPhysacWorld::SolveCircleToPolygon(PhysicsManifold* manifold) {
     // It is the same concept as using support points in SolvePolygonToPolygon
     float separation = -PHYSAC_FLT_MAX;
     int faceNormal = 0;
-    PolygonData vertexData = bodyB->shape.vertexData;
+    const PolygonData &vertexData = bodyB->shape.vertexData;
 
     for (int i = 0; i < vertexData.positions.size(); i++) {
         float currentSeparation = MPhysac::MathDot(vertexData.normals[i], center - vertexData.positions[i]);
@@ -434,6 +492,9 @@ void MPhysacWorld::SolvePolygonToCircle(PhysicsManifold* manifold) {
     manifold->bodyB = bodyA;
     SolveCircleToPolygon(manifold);
 
+    // Back to the polygon as body A : the normal goes from A to B again once flipped
+    manifold->bodyA = bodyA;
+    manifold->bodyB = bodyB;
     manifold->normal.x *= -1.0f;
     manifold->normal.y *= -1.0f;
 }
@@ -442,8 +503,8 @@ void MPhysacWorld::SolvePolygonToCircle(PhysicsManifold* manifold) {
 void MPhysacWorld::SolvePolygonToPolygon(PhysicsManifold* manifold) {
     if ((manifold->bodyA == nullptr) || (manifold->bodyB == nullptr)) return;
 
-    MPhysacShape bodyA = manifold->bodyA->shape;
-    MPhysacShape bodyB = manifold->bodyB->shape;
+    const MPhysacShape &bodyA = manifold->bodyA->shape;
+    const MPhysacShape &bodyB = manifold->bodyB->shape;
     manifold->contactsCount = 0;
 
     // Check for separating axis with A shape's face planes
@@ -459,27 +520,20 @@ void MPhysacWorld::SolvePolygonToPolygon(PhysicsManifold* manifold) {
     int referenceIndex = 0;
     bool flip = false;  // Always point from A shape to B shape
 
-    MPhysacShape refPoly; // Reference
-    MPhysacShape incPoly; // Incident
-
     // Determine which shape contains reference face
-    if (BiasGreaterThan(penetrationA, penetrationB)) {
-        refPoly = bodyA;
-        incPoly = bodyB;
-        referenceIndex = faceA;
-    } else {
-        refPoly = bodyB;
-        incPoly = bodyA;
-        referenceIndex = faceB;
+    if (!BiasGreaterThan(penetrationA, penetrationB))
         flip = true;
-    }
+
+    const MPhysacShape &refPoly = flip ? bodyB : bodyA; // Reference
+    const MPhysacShape &incPoly = flip ? bodyA : bodyB; // Incident
+    referenceIndex = flip ? faceB : faceA;
 
     // World space incident face
     Vector2f incidentFace[2];
     FindIncidentFace(&incidentFace[0], &incidentFace[1], refPoly, incPoly, referenceIndex);
 
     // Setup reference face vertices
-    PolygonData refData = refPoly.vertexData;
+    const PolygonData &refData = refPoly.vertexData;
     Vector2f v1 = refData.positions[referenceIndex];
     referenceIndex = (((referenceIndex + 1) < refData.positions.size()) ? (referenceIndex + 1) : 0);
     Vector2f v2 = refData.positions[referenceIndex];
@@ -714,7 +768,7 @@ void MPhysacWorld::CorrectPhysicsPositions(PhysicsManifold* manifold) {
 Vector2f MPhysacWorld::GetSupport(const MPhysacShape& shape, const Vector2f& dir) {
     float bestProjection = -PHYSAC_FLT_MAX;
     Vector2f bestVertex;
-    PolygonData data = shape.vertexData;
+    const PolygonData &data = shape.vertexData;
 
     for (size_t i = 0; i < data.positions.size(); i++) {
         Vector2f vertex = data.positions[i];
@@ -734,7 +788,7 @@ float MPhysacWorld::FindAxisLeastPenetration(int* faceIndex, const MPhysacShape&
     float bestDistance = -PHYSAC_FLT_MAX;
     int bestIndex = 0;
 
-    PolygonData dataA = shapeA.vertexData;
+    const PolygonData &dataA = shapeA.vertexData;
     //PolygonData dataB = shapeB.vertexData;
 
     for (size_t i = 0; i < dataA.positions.size(); i++) {
@@ -752,7 +806,7 @@ float MPhysacWorld::FindAxisLeastPenetration(int* faceIndex, const MPhysacShape&
         // Retrieve vertex on face from A shape, transform into B shape's model space
         Vector2f vertex = dataA.positions[i];
         vertex = MPhysac::Mat2MultiplyVector2(shapeA.transform, vertex);
-        vertex = vertex - shapeA.body->position;
+        vertex = vertex + shapeA.body->position;
         vertex = vertex - shapeB.body->position;
         vertex = MPhysac::Mat2MultiplyVector2(buT, vertex);
 
@@ -772,8 +826,8 @@ float MPhysacWorld::FindAxisLeastPenetration(int* faceIndex, const MPhysacShape&
 
 // Finds two polygon shapes incident face
 void MPhysacWorld::FindIncidentFace(Vector2f* v0, Vector2f* v1, const MPhysacShape& ref, const MPhysacShape& inc, int index) {
-    PolygonData refData = ref.vertexData;
-    PolygonData incData = inc.vertexData;
+    const PolygonData &refData = ref.vertexData;
+    const PolygonData &incData = inc.vertexData;
 
     Vector2f referenceNormal = refData.normals[index];
 
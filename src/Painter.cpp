@@ -0,0 +1,75 @@
+#include "Painter.hpp"
+
+#include "RenderCapture.hpp"
+#include "RenderState.hpp"
+#include "ResourcesLoader.hpp"
+#include "TextureHandle.hpp"
+#include "Utils/AllocTracker.hpp"
+
+void Painter::copy(const TextureHandle& texture, const SDL_Rect& src, const SDL_Rect& dst) const {
+	if (recording) {
+		// The texture is resolved when the state is submitted, on the rendering thread
+		recording->commands.push_back(RenderCommand{ texture.getID(), src, dst });
+		return;
+	}
+
+	blit(texture.getID(), texture.get(), src, dst);
+}
+
+void Painter::submit(const RenderState& state, ResourcesLoader& rl) const {
+	MECHA_ALLOC_HOT_PATH("Painter::submit");
+
+	// The handles of the state may have been released since it was recorded, an evicted texture is reloaded
+	for (auto &command : state.commands)
+		blit(command.image, rl.use(command.image), command.src, command.dst);
+}
+
+void Painter::blit(Image::ID image, SDL_Texture *texture, const SDL_Rect& src, const SDL_Rect& dst) const {
+	if (!hasView) {
+		renderCopy(image, texture, src, dst);
+		return;
+	}
+
+	if (!SDL_HasIntersection(&dst, &view)) {
+		culled++;
+		if (capture)
+			capture->addCulled();
+		return;
+	}
+
+	const SDL_Rect screen = { dst.x - view.x, dst.y - view.y, dst.w, dst.h };
+	renderCopy(image, texture, src, screen);
+}
+
+void Painter::renderCopy(Image::ID image, SDL_Texture *texture, const SDL_Rect& src, const SDL_Rect& dst) const {
+	SDL_RenderCopy(renderer, texture, &src, &dst);
+	drawCalls++;
+	if (capture)
+		capture->add(image, src, dst);
+
+	if (texture != lastTexture) {
+		textureSwitches++;
+		lastTexture = texture;
+	}
+}
+
+void Painter::fillRects(const SDL_Rect *rects, int count, const SDL_Color& color) const {
+	// The draw color is also the clear color, it is restored
+	Uint8 r, g, b, a;
+	SDL_BlendMode blendMode;
+	SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+	SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+	SDL_RenderFillRects(renderer, rects, count);
+
+	SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	SDL_SetRenderDrawBlendMode(renderer, blendMode);
+}
+
+void Painter::copyScreen(SDL_Texture *texture, const SDL_Rect& src, const SDL_Rect& dst) const {
+	// Not counted, but the next copy of the scene does switch back
+	SDL_RenderCopy(renderer, texture, &src, &dst);
+	lastTexture = texture;
+}
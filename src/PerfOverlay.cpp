@@ -0,0 +1,201 @@
+#include "PerfOverlay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+
+#include "Painter.hpp"
+#include "Utils/AllocTracker.hpp"
+
+namespace {
+	// 3x5 glyphs of the characters 32 to 95, one bit per pixel, the top left pixel in the highest of the 15 bits.
+	// The lower case letters are drawn in upper case.
+	const Uint16 glyphs[64] = {
+		0x0000, 0x2482, 0x5a00, 0x5f7d, 0x3c9e, 0x42a1, 0x2aab, 0x2400,
+		0x1491, 0x4494, 0x0aa8, 0x05d0, 0x0014, 0x01c0, 0x0002, 0x12a4,
+		0x7b6f, 0x2c97, 0x73e7, 0x73cf, 0x5bc9, 0x79cf, 0x79ef, 0x7249,
+		0x7bef, 0x7bcf, 0x0410, 0x0414, 0x1511, 0x0e38, 0x4454, 0x72c2,
+		0x7be7, 0x2bed, 0x6bae, 0x3923, 0x6b6e, 0x79a7, 0x79a4, 0x396b,
+		0x5bed, 0x7497, 0x126a, 0x5bad, 0x4927, 0x5fed, 0x6b6d, 0x2b6a,
+		0x6ba4, 0x2b73, 0x6bad, 0x388e, 0x7492, 0x5b6f, 0x5b6a, 0x5bfd,
+		0x5aad, 0x5a92, 0x72a7, 0x6926, 0x4889, 0x324b, 0x2a00, 0x0007,
+	};
+
+	const int GlyphWidth = 3, GlyphHeight = 5;
+	const int GlyphScale = 2;
+	const int Advance = (GlyphWidth + 1) * GlyphScale;
+	const int LineHeight = (GlyphHeight + 1) * GlyphScale;
+
+	const int Margin = 8;
+	const int PanelWidth = 400;
+	const int GraphHeight = 60;
+	const float GraphMaxMs = 100.f / 3.f;     // Two 60 Hz frames fill the graph
+	const float FrameBudgetMs = 1000.f / 60.f;
+
+	const SDL_Color Background = { 0, 0, 0, 160 };
+	const SDL_Color InBudget = { 64, 200, 96, 255 };
+	const SDL_Color OverBudget = { 224, 64, 48, 255 };
+	const SDL_Color BudgetLine = { 255, 255, 255, 96 };
+}
+
+PerfOverlay::PerfOverlay() :
+	font(nullptr),
+	visible(true),
+	frameIndex(0),
+	framesCount(0),
+	bodies(0),
+	manifolds(0),
+	drawCalls(0),
+	textureBytes(0),
+	drawDuration(0.f)
+{
+	frames.fill(0.f);
+	for (auto &phase : phases)
+		phase = 0.f;
+	for (auto &line : lines)
+		line[0] = '\0';
+}
+
+PerfOverlay::~PerfOverlay() {
+	if (font)
+		SDL_DestroyTexture(font);
+}
+
+void PerfOverlay::init(SDL_Renderer *renderer) {
+	const int width = GlyphWidth * 64;
+	std::array<Uint32, GlyphWidth * 64 * GlyphHeight> pixels;
+
+	for (int c = 0; c < 64; c++)
+		for (int y = 0; y < GlyphHeight; y++)
+			for (int x = 0; x < GlyphWidth; x++) {
+				const int bit = (GlyphHeight - 1 - y) * GlyphWidth + (GlyphWidth - 1 - x);
+				pixels[y * width + c * GlyphWidth + x] = (glyphs[c] >> bit) & 1 ? 0xFFFFFFFF : 0;
+			}
+
+	font = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, width, GlyphHeight);
+	if (!font) {
+		std::cerr << "[Warning] PerfOverlay::init - font texture not created: " << SDL_GetError() << std::endl;
+		return;
+	}
+
+	SDL_UpdateTexture(font, NULL, pixels.data(), width * (int)sizeof(Uint32));
+	SDL_SetTextureBlendMode(font, SDL_BLENDMODE_BLEND);
+}
+
+void PerfOverlay::addFrame(float ms) {
+	frames[frameIndex] = ms;
+	frameIndex = (frameIndex + 1) % HistorySize;
+	framesCount = std::min(framesCount + 1, (unsigned int)HistorySize);
+}
+
+void PerfOverlay::addPhase(Phase phase, float ms) {
+	// A single thread reports each phase, a plain load and store is enough
+	phases[phase] = phases[phase] * 0.9f + ms * 0.1f;
+}
+
+void PerfOverlay::setLine(unsigned int line, const char *format, ...) {
+	if (line >= MaxLines)
+		return;
+
+	va_list args;
+	va_start(args, format);
+	std::vsnprintf(lines[line], LineLength, format, args);
+	va_end(args);
+}
+
+void PerfOverlay::draw(const Painter &painter) const {
+	typedef std::chrono::steady_clock Clock;
+
+	if (!visible || !font)
+		return;
+
+	MECHA_ALLOC_HOT_PATH("PerfOverlay::draw");
+
+	const Clock::time_point start = Clock::now();
+
+	// Percentiles of the history
+	std::array<float, HistorySize> sorted;
+	std::copy(frames.begin(), frames.begin() + framesCount, sorted.begin());
+	const auto end = sorted.begin() + framesCount;
+	float p50 = 0.f, p99 = 0.f, max = 0.f;
+	if (framesCount) {
+		std::nth_element(sorted.begin(), sorted.begin() + framesCount / 2, end);
+		p50 = sorted[framesCount / 2];
+		std::nth_element(sorted.begin(), sorted.begin() + framesCount * 99 / 100, end);
+		p99 = sorted[framesCount * 99 / 100];
+		max = *std::max_element(sorted.begin() + framesCount * 99 / 100, end);
+	}
+
+	unsigned int linesCount = 4;
+	for (auto &line : lines)
+		if (line[0])
+			linesCount++;
+
+	const int graphTop = Margin * 2 + (int)linesCount * LineHeight;
+	painter.fillRect(SDL_Rect{ Margin, Margin, PanelWidth, graphTop + GraphHeight }, Background);
+
+	// Text
+	char text[LineLength];
+	int y = Margin * 2;
+
+	std::snprintf(text, sizeof(text), "FRAME P50 %.2f P99 %.2f MAX %.2f MS", p50, p99, max);
+	y += drawText(painter, Margin * 2, y, text);
+	std::snprintf(text, sizeof(text), "UPDATE %.2f PHYSICS %.2f RENDER %.2f MS",
+		phases[Update].load(), phases[Physics].load(), phases[Render].load());
+	y += drawText(painter, Margin * 2, y, text);
+	std::snprintf(text, sizeof(text), "BODIES %u MANIFOLDS %u", bodies.load(), manifolds.load());
+	y += drawText(painter, Margin * 2, y, text);
+	std::snprintf(text, sizeof(text), "DRAWS %u TEXTURES %u KIB OVERLAY %.3f MS", drawCalls, (unsigned int)(textureBytes / 1024), drawDuration);
+	y += drawText(painter, Margin * 2, y, text);
+	for (auto &line : lines)
+		if (line[0])
+			y += drawText(painter, Margin * 2, y, line);
+
+	// Graph, oldest frame on the left. The frames over budget are gathered from the end of the array, so that each color is a single call.
+	std::array<SDL_Rect, HistorySize> bars;
+	unsigned int inBudget = 0, overBudget = 0;
+	const int graphBottom = graphTop + GraphHeight;
+	const int graphLeft = Margin * 2 + (PanelWidth - Margin * 2 - (int)HistorySize) / 2;
+
+	for (unsigned int i = 0; i < framesCount; i++) {
+		const float ms = frames[(frameIndex + HistorySize - framesCount + i) % HistorySize];
+		const int height = std::max(1, (int)(std::min(ms / GraphMaxMs, 1.f) * (float)(GraphHeight - Margin)));
+		const SDL_Rect bar = { graphLeft + (int)(HistorySize - framesCount + i), graphBottom - height, 1, height };
+
+		if (ms <= FrameBudgetMs)
+			bars[inBudget++] = bar;
+		else
+			bars[HistorySize - ++overBudget] = bar;
+	}
+
+	if (inBudget)
+		painter.fillRects(bars.data(), (int)inBudget, InBudget);
+	if (overBudget)
+		painter.fillRects(bars.data() + HistorySize - overBudget, (int)overBudget, OverBudget);
+
+	const int budgetHeight = (int)(FrameBudgetMs / GraphMaxMs * (float)(GraphHeight - Margin));
+	painter.fillRect(SDL_Rect{ graphLeft, graphBottom - budgetHeight, (int)HistorySize, 1 }, BudgetLine);
+
+	drawDuration = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+int PerfOverlay::drawText(const Painter &painter, int x, int y, const char *text) const {
+	for (; *text; text++, x += Advance) {
+		int c = (unsigned char)*text;
+		if (c >= 'a' && c <= 'z')
+			c -= 'a' - 'A';
+		if (c < 32 || c > 95)
+			c = '?';
+
+		if (c == ' ')
+			continue;
+
+		const SDL_Rect src = { (c - 32) * GlyphWidth, 0, GlyphWidth, GlyphHeight };
+		const SDL_Rect dst = { x, y, GlyphWidth * GlyphScale, GlyphHeight * GlyphScale };
+		painter.copyScreen(font, src, dst);
+	}
+
+	return LineHeight;
+}
@@ -0,0 +1,60 @@
+#include "RenderCapture.hpp"
+
+#include <stdexcept>
+
+RenderCaptureWriter::RenderCaptureWriter(const std::string& filename, int screenWidth, int screenHeight) :
+	file(filename, std::ios::binary | std::ios::trunc),
+	culled(0),
+	frame(0)
+{
+	if (!file)
+		throw std::runtime_error("[Error] RenderCaptureWriter::RenderCaptureWriter - failed to create " + filename);
+
+	const Capture::Header header = { Capture::Magic, Capture::Version, (uint32_t)screenWidth, (uint32_t)screenHeight };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// A crowded frame must not grow the array while the painter draws
+	commands.reserve(16384);
+}
+
+void RenderCaptureWriter::endFrame() {
+	const Capture::FrameHeader header = { frame, (uint32_t)commands.size(), culled };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(commands.data()), (std::streamsize)(commands.size() * sizeof(Capture::Command)));
+
+	commands.clear();
+	culled = 0;
+	frame++;
+}
+
+RenderCaptureReader::RenderCaptureReader(const std::string& filename) :
+	filename(filename),
+	file(filename, std::ios::binary)
+{
+	if (!file)
+		throw std::runtime_error("[Error] RenderCaptureReader::RenderCaptureReader - failed to open " + filename);
+
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != Capture::Magic)
+		throw std::runtime_error("[Error] RenderCaptureReader::RenderCaptureReader - " + filename + " is not a render capture");
+	if (header.version != Capture::Version)
+		throw std::runtime_error("[Error] RenderCaptureReader::RenderCaptureReader - unsupported version of " + filename);
+}
+
+bool RenderCaptureReader::next(Frame& frame) {
+	Capture::FrameHeader frameHeader;
+	if (!file.read(reinterpret_cast<char*>(&frameHeader), sizeof(frameHeader))) {
+		if (file.gcount() == 0)
+			return false;
+		throw std::runtime_error("[Error] RenderCaptureReader::next - " + filename + " is truncated");
+	}
+
+	frame.frame = frameHeader.frame;
+	frame.culledCount = frameHeader.culledCount;
+	frame.commands.resize(frameHeader.commandsCount);
+
+	const std::streamsize bytes = (std::streamsize)(frame.commands.size() * sizeof(Capture::Command));
+	if (bytes && !file.read(reinterpret_cast<char*>(frame.commands.data()), bytes))
+		throw std::runtime_error("[Error] RenderCaptureReader::next - " + filename + " is truncated");
+
+	return true;
+}
@@ -3,10 +3,12 @@
 #include <SDL.h>
 
 #include "Window.hpp"
+#include "Utils/StartupTimeline.hpp"
 
-Renderer::Renderer(const Window &win) :
-	r(SDL_CreateRenderer(win.w, -1, 0))
-{}
+Renderer::Renderer(const Window &win, bool vsync) {
+	StartupTimeline::Stage stage("Renderer");
+	r = SDL_CreateRenderer(win.w, -1, vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+}
 
 Renderer::~Renderer() {
 	SDL_DestroyRenderer(r);
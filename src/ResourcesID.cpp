@@ -0,0 +1,16 @@
+#include "ResourcesID.hpp"
+
+#include <stdexcept>
+
+const char* Image::fileName(Image::ID id) {
+	switch (id) {
+	case Image::Player: return "anim_sprite.png";
+	default: break;
+	}
+
+	throw std::runtime_error("[Error] Image::fileName - unknown image id");
+}
+
+std::string Room::fileName(Room::ID id) {
+	return "rooms/room_" + std::to_string(id) + ".txt";
+}
@@ -1,61 +1,510 @@
 #include "ResourcesLoader.hpp"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <cassert>
 
-ResourcesLoader::ResourcesLoader(SDL_Renderer* renderer) :
-	renderer(renderer) {
-	imgFileMap = { {Image::Player, "anim_sprite.png"} };
+#include "Utils/AllocTracker.hpp"
+#include "Utils/Metrics.hpp"
+#include "Utils/StartupTimeline.hpp"
+
+namespace {
+	struct LoaderMetrics {
+		LoaderMetrics() :
+			texturesLoaded(Metrics::counter("resources.textures_loaded")),
+			evictions(Metrics::counter("resources.evictions")),
+			residentBytes(Metrics::gauge("resources.resident_bytes")),
+			loadDuration(Metrics::histogram("resources.load_us"))
+		{}
+
+		Metrics::Counter &texturesLoaded, &evictions;
+		Metrics::Gauge &residentBytes;
+		Metrics::Histogram &loadDuration;
+	};
+
+	LoaderMetrics& metrics() {
+		static LoaderMetrics instance;
+		return instance;
+	}
+}
+
+ResourcesLoader::ResourcesLoader(SDL_Renderer* renderer, const std::string& packFile, const std::string& spritesFile) :
+	renderer(renderer),
+	loadDuration(0.f),
+	packLoads(0),
+	fileLoads(0),
+	slots(Image::Count),
+	owners(Image::Count),
+	frames(Image::Count),
+	framesVersion(0),
+	spritesFile(spritesFile),
+	currentRoom(nullptr),
+	prefetchStats{0, 0, 0},
+	memoryBudget(256 * 1024 * 1024),
+	usedBytes(0),
+	evictions(0),
+	frame(0),
+	prefetcher(pack) {
+	StartupTimeline::Stage stage("ResourcesLoader");
+
 	correspondingImgMap = { {Image::Player, {} } };
+
+	for (int i = 0; i < Image::Count; ++i) {
+		slots[i].texture = nullptr;
+		slots[i].id = (Image::ID)i;
+		slots[i].bytes = 0;
+		slots[i].refCount.store(0, std::memory_order_relaxed);
+		slots[i].lastUse = 0;
+		slots[i].resident = false;
+
+		owners[i] = (Image::ID)i;
+	}
+
+	// Corresponding images share the slot of the image they correspond to
+	for (auto &kv : correspondingImgMap)
+		for (auto img : kv.second)
+			owners[img] = kv.first;
+
+	if (!packFile.empty() && !pack.open(packFile))
+		std::cerr << "[Warning] ResourcesLoader - no pack " << packFile << ", loading loose image files" << std::endl;
+
+	if (!spritesFile.empty())
+		loadSpritesDefinitions(spritesFile);
 }
 
 ResourcesLoader::~ResourcesLoader() {
-	for(auto &kv : texturesMap)
-		SDL_DestroyTexture(kv.second);
+	for (auto &kv : prefetchedSurfaces)
+		SDL_FreeSurface(kv.second);
+
+	for(auto &slot : slots)
+		if (slot.texture)
+			SDL_DestroyTexture(slot.texture);
 }
 
 void ResourcesLoader::load(Image::ID id) {
+	MECHA_ALLOC_TAG(Resources);
 
-	if (texturesMap.find(id) == texturesMap.end()) { // Texture already loaded?
+	// Headless : nothing is ever drawn
+	if (!renderer)
+		return;
 
-		const std::string &filename = imgFileMap[id];
-		
-		SDL_Texture* loaded(IMG_LoadTexture(renderer, filename.c_str()));
+	TextureSlot &slot = slotOf(id);
+
+	if (!slot.texture) { // Texture already loaded?
+		std::chrono::time_point<std::chrono::steady_clock> start(std::chrono::steady_clock::now());
+
+		SDL_Texture* loaded(loadFromPack(slot.id));
+		if (loaded) {
+			packLoads++;
+		} else if ((loaded = loadFromSurface(slot.id))) {
+			fileLoads++;
+		} else {
+			const std::string filename(Image::fileName(slot.id));
+
+			loaded = IMG_LoadTexture(renderer, filename.c_str());
 			if (!loaded) // NULL ?
 				throw std::runtime_error("[Error] ResourcesLoader::load - failed to load " + filename);
 
-		// Insert the texture for all corresponding images
-		texturesMap.insert(std::make_pair(id, loaded));
-		for (auto img : correspondingImgMap[id])
-			texturesMap.insert(std::make_pair(img, loaded));
+			fileLoads++;
+		}
+
+		Uint32 format;
+		int w, h;
+		SDL_QueryTexture(loaded, &format, nullptr, &w, &h);
+
+		slot.texture = loaded;
+		slot.bytes = (size_t)w * (size_t)h * SDL_BYTESPERPIXEL(format);
+		slot.lastUse = frame;
+		usedBytes += slot.bytes;
+
+		const std::chrono::steady_clock::duration loading = std::chrono::steady_clock::now() - start;
+		loadDuration += loading;
+
+		metrics().texturesLoaded.add();
+		metrics().residentBytes.set((int64_t)usedBytes);
+		metrics().loadDuration.record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(loading).count());
+
+		trim();
 	}
 }
 
-// void ResourcesLoader::unload(Image::ID id) {
-// 	// Check if resource with the key "id" exist and delete it
-// 	auto found = texturesMap.find(id);
-// 	SDL_DestroyTexture(found->second);
-	
-// 	size_t nbErased = texturesMap.erase(id);
-// 	if (!nbErased)
-// 		std::cerr << "[Warning] ResourcesLoader::unload - nothing to unload for key " << id << std::endl;
-// }
+// Pixels are already decoded in the mapping, only the upload remains
+SDL_Texture* ResourcesLoader::loadFromPack(Image::ID id) {
+	ResourcesPack::Entry entry;
+	if (!pack.find(id, entry))
+		return nullptr;
+
+	SDL_Texture* texture(SDL_CreateTexture(renderer, entry.format, SDL_TEXTUREACCESS_STATIC, entry.width, entry.height));
+	if (!texture)
+		throw std::runtime_error("[Error] ResourcesLoader::loadFromPack - failed to create texture: " + std::string(SDL_GetError()));
+
+	if (SDL_UpdateTexture(texture, nullptr, entry.pixels, entry.pitch) != 0) {
+		SDL_DestroyTexture(texture);
+		throw std::runtime_error("[Error] ResourcesLoader::loadFromPack - failed to upload texture: " + std::string(SDL_GetError()));
+	}
+
+	// Same blending as IMG_LoadTexture gives to images with an alpha channel
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	return texture;
+}
+
+// Images decoded in the background by the prefetcher
+SDL_Texture* ResourcesLoader::loadFromSurface(Image::ID id) {
+	auto found = prefetchedSurfaces.find(id);
+	if (found == prefetchedSurfaces.end())
+		return nullptr;
+
+	SDL_Texture* texture(SDL_CreateTextureFromSurface(renderer, found->second));
+	SDL_FreeSurface(found->second);
+	prefetchedSurfaces.erase(found);
+
+	if (!texture)
+		throw std::runtime_error("[Error] ResourcesLoader::loadFromSurface - failed to create texture: " + std::string(SDL_GetError()));
+
+	return texture;
+}
+
+void ResourcesLoader::unload(Image::ID id) {
+	TextureSlot &slot = slotOf(id);
+
+	if (!slot.texture)
+		std::cerr << "[Warning] ResourcesLoader::unload - nothing to unload for key " << id << std::endl;
+	else if (slot.refCount.load(std::memory_order_acquire) > 0)
+		std::cerr << "[Warning] ResourcesLoader::unload - key " << id << " is still referenced" << std::endl;
+	else
+		evict(slot);
+}
 
 SDL_Texture* ResourcesLoader::get(Image::ID id) {
-	auto found = texturesMap.find(id);
+	TextureSlot &slot = slotOf(id);
 
-	if(found == texturesMap.end())
+	if(!slot.texture)
 		throw std::runtime_error("[Error] ResourcesLoader::get - failed to get the resource");
-	
-	return found->second;
+
+	slot.lastUse = frame;
+	return slot.texture;
 }
 
 const SDL_Texture* ResourcesLoader::get(Image::ID id) const {
-	auto found = texturesMap.find(id);
+	const TextureSlot &slot = slotOf(id);
 
-	if(found == texturesMap.end())
+	if(!slot.texture)
 		throw std::runtime_error("[Error] ResourcesLoader::get - failed to get the resource");
 
-	return found->second;
-}
\ No newline at end of file
+	return slot.texture;
+}
+
+const std::vector<SDL_Rect>& ResourcesLoader::defineFrames(Image::ID id, const std::vector<SDL_Rect>& rects) {
+	if (frames[id].empty()) {
+		frames[id] = rects;
+		framesVersion++;
+	}
+
+	return frames[id];
+}
+
+bool ResourcesLoader::loadSpritesDefinitions(const std::string& filename) {
+	std::ifstream file(filename);
+	if (!file)
+		return false;
+
+	// Parse everything first, so that a malformed file leaves the current frames untouched
+	std::map<Image::ID, std::vector<SDL_Rect>> definitions;
+
+	std::string line;
+	for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+		std::istringstream in(line);
+		std::string keyword;
+
+		if (!(in >> keyword) || keyword[0] == '#')
+			continue;
+
+		int img = -1;
+		in >> img;
+		if (keyword != "frames" || img < 0 || img >= Image::Count)
+			throw std::runtime_error("[Error] ResourcesLoader::loadSpritesDefinitions - malformed line " + filename + ":" + std::to_string(lineNumber));
+
+		std::vector<SDL_Rect> &rects = definitions[(Image::ID)img];
+		SDL_Rect rect;
+		while (in >> rect.x >> rect.y >> rect.w >> rect.h)
+			rects.push_back(rect);
+
+		if (rects.empty() || !in.eof())
+			throw std::runtime_error("[Error] ResourcesLoader::loadSpritesDefinitions - malformed frames " + filename + ":" + std::to_string(lineNumber));
+	}
+
+	for (auto &kv : definitions)
+		frames[kv.first] = kv.second;
+	framesVersion++;
+
+	return true;
+}
+
+void ResourcesLoader::setHotReload(bool enabled) {
+	if (!enabled) {
+		watcher.reset();
+		return;
+	}
+
+	watcher.reset(new FileWatcher());
+
+	for (int i = 0; i < Image::Count; ++i)
+		watcher->watch(Image::fileName((Image::ID)i));
+
+	if (!spritesFile.empty())
+		watcher->watch(spritesFile);
+}
+
+// Swaps the textures of the modified images inside their slots, the handles stay valid
+void ResourcesLoader::hotReload() {
+	std::vector<std::string> modified;
+	watcher->poll(modified);
+
+	for (auto &filename : modified) {
+		if (filename == spritesFile) {
+			try {
+				loadSpritesDefinitions(spritesFile);
+				std::cout << "[Info] ResourcesLoader - reloaded " << spritesFile << std::endl;
+			} catch (std::exception &e) {
+				std::cerr << e.what() << std::endl;
+			}
+			continue;
+		}
+
+		// Evicted or never loaded images will read the new file on their next load
+		for (int i = 0; i < Image::Count; ++i)
+			if (filename == Image::fileName((Image::ID)i) && slots[i].texture)
+				prefetcher.requestImage((Image::ID)i);
+	}
+
+	std::vector<std::pair<Image::ID, SDL_Surface*>> images;
+	prefetcher.collectImages(images);
+
+	for (auto &image : images) {
+		TextureSlot &slot = slots[image.first];
+
+		if (!image.second) {
+			std::cerr << "[Warning] ResourcesLoader::hotReload - failed to reload " << Image::fileName(image.first) << std::endl;
+			continue;
+		}
+
+		SDL_Texture* texture(slot.texture ? SDL_CreateTextureFromSurface(renderer, image.second) : nullptr);
+		SDL_FreeSurface(image.second);
+		if (!texture)
+			continue;
+
+		Uint32 format;
+		int w, h;
+		SDL_QueryTexture(texture, &format, nullptr, &w, &h);
+
+		SDL_DestroyTexture(slot.texture);
+		usedBytes -= slot.bytes;
+
+		slot.texture = texture;
+		slot.bytes = (size_t)w * (size_t)h * SDL_BYTESPERPIXEL(format);
+		usedBytes += slot.bytes;
+		metrics().residentBytes.set((int64_t)usedBytes);
+
+		std::cout << "[Info] ResourcesLoader - reloaded " << Image::fileName(image.first) << std::endl;
+	}
+}
+
+void ResourcesLoader::setRoomImages(Room::ID room, const std::vector<Image::ID>& images) {
+	roomImagesMap[room] = images;
+
+	if (std::find(residentRooms.begin(), residentRooms.end(), room) != residentRooms.end())
+		for (auto img : images)
+			slotOf(img).resident = true;
+}
+
+void ResourcesLoader::setResidentRooms(Room::ID current, const std::vector<Room::ID>& adjacent) {
+	residentRooms = adjacent;
+	residentRooms.push_back(current);
+
+	for (auto &slot : slots)
+		slot.resident = false;
+
+	for (auto room : residentRooms)
+		for (auto img : roomImagesMap[room])
+			slotOf(img).resident = true;
+
+	// The current room must be ready before its first frame, the adjacent ones are loaded on first use
+	for (auto img : roomImagesMap[current])
+		load(img);
+
+	trim();
+}
+
+const RoomData& ResourcesLoader::enterRoom(Room::ID id) {
+	MECHA_ALLOC_TAG(Resources);
+
+	// Half loaded already : waiting is shorter than loading it a second time
+	if (!rooms.count(id) && prefetcher.isPending(id))
+		prefetcher.wait(id);
+
+	collectPrefetched();
+
+	auto found = rooms.find(id);
+	if (found != rooms.end()) {
+		prefetchStats.hits++;
+	} else {
+		prefetchStats.misses++;
+
+		RoomData room;
+		if (!room.loadFromFile(id, Room::fileName(id)))
+			throw std::runtime_error("[Error] ResourcesLoader::enterRoom - failed to load " + Room::fileName(id));
+
+		setRoomImages(id, room.images);
+		found = rooms.insert(std::make_pair(id, std::move(room))).first;
+	}
+
+	currentRoom = &found->second;
+
+	// Images already uploaded or decoded in the background do not stall the transition
+	for (auto img : currentRoom->images) {
+		const TextureSlot &slot = slotOf(img);
+		if (slot.texture || prefetchedSurfaces.count(slot.id))
+			prefetchStats.hits++;
+		else
+			prefetchStats.misses++;
+	}
+
+	std::vector<Room::ID> adjacent;
+	for (auto &door : currentRoom->doors)
+		adjacent.push_back(door.target);
+
+	// Only the current room and its neighbours are kept
+	for (auto it = rooms.begin(); it != rooms.end(); ) {
+		if (it->first != id && std::find(adjacent.begin(), adjacent.end(), it->first) == adjacent.end())
+			it = rooms.erase(it);
+		else
+			++it;
+	}
+
+	setResidentRooms(id, adjacent);
+
+	return *currentRoom;
+}
+
+const RoomData* ResourcesLoader::findRoom(Room::ID room) const {
+	auto found = rooms.find(room);
+	return found != rooms.end() ? &found->second : nullptr;
+}
+
+void ResourcesLoader::prefetchRoom(Room::ID room) {
+	if (rooms.count(room) || prefetcher.isPending(room))
+		return;
+
+	prefetchStats.requests++;
+	prefetcher.request(room);
+}
+
+void ResourcesLoader::prefetchNear(const Vector2f& position, float lookahead) {
+	MECHA_ALLOC_TAG(Resources);
+
+	if (!currentRoom)
+		return;
+
+	for (auto &door : currentRoom->doors) {
+		// Distance from the position to the door rectangle
+		float dx = std::max(std::max((float)door.area.x - position.x, 0.f), position.x - (float)(door.area.x + door.area.w));
+		float dy = std::max(std::max((float)door.area.y - position.y, 0.f), position.y - (float)(door.area.y + door.area.h));
+
+		if (dx * dx + dy * dy <= lookahead * lookahead)
+			prefetchRoom(door.target);
+	}
+}
+
+void ResourcesLoader::update(unsigned int maxUploads) {
+	MECHA_ALLOC_TAG(Resources);
+
+	if (watcher)
+		hotReload();
+
+	collectPrefetched();
+
+	for (unsigned int i = 0; i < maxUploads && !prefetchedSurfaces.empty(); ++i)
+		load(prefetchedSurfaces.begin()->first); // Consumes the surface
+}
+
+void ResourcesLoader::collectPrefetched() {
+	std::vector<ResourcesPrefetcher::Result> results;
+	prefetcher.collect(results);
+
+	for (auto &result : results) {
+		if (!result.valid) {
+			std::cerr << "[Warning] ResourcesLoader - failed to prefetch " << Room::fileName(result.room.id) << std::endl;
+			continue;
+		}
+
+		for (auto &surface : result.surfaces) {
+			// Loaded in the meantime, or never uploaded (headless)
+			if (!renderer || slotOf(surface.first).texture || !prefetchedSurfaces.insert(surface).second)
+				SDL_FreeSurface(surface.second);
+		}
+
+		if (!rooms.count(result.room.id)) {
+			setRoomImages(result.room.id, result.room.images);
+			rooms.insert(std::make_pair(result.room.id, std::move(result.room)));
+		}
+	}
+}
+
+TextureSlot* ResourcesLoader::acquire(Image::ID id) {
+	TextureSlot &slot = slotOf(id);
+
+	load(slot.id);
+	slot.refCount.fetch_add(1, std::memory_order_relaxed);
+
+	return &slot;
+}
+
+void ResourcesLoader::release(TextureSlot *slot) {
+	const unsigned int previous = slot->refCount.fetch_sub(1, std::memory_order_acq_rel);
+	assert(previous > 0);
+	(void)previous;
+}
+
+SDL_Texture* ResourcesLoader::use(TextureSlot *slot) {
+	if (!slot->texture)
+		load(slot->id);
+
+	slot->lastUse = frame;
+	return slot->texture;
+}
+
+void ResourcesLoader::evict(TextureSlot &slot) {
+	SDL_DestroyTexture(slot.texture);
+	slot.texture = nullptr;
+
+	usedBytes -= slot.bytes;
+	evictions++;
+
+	metrics().evictions.add();
+	metrics().residentBytes.set((int64_t)usedBytes);
+}
+
+// Evicts the least recently used textures which are neither referenced nor resident until the budget is respected
+void ResourcesLoader::trim() {
+	if (usedBytes <= memoryBudget)
+		return;
+
+	std::vector<TextureSlot*> candidates;
+	for (auto &slot : slots)
+		if (slot.texture && slot.refCount.load(std::memory_order_acquire) == 0 && !slot.resident)
+			candidates.push_back(&slot);
+
+	std::sort(candidates.begin(), candidates.end(), [](const TextureSlot *a, const TextureSlot *b) {
+		return a->lastUse < b->lastUse;
+	});
+
+	for (size_t i = 0; i < candidates.size() && usedBytes > memoryBudget; ++i)
+		evict(*candidates[i]);
+
+	if (usedBytes > memoryBudget)
+		std::cerr << "[Warning] ResourcesLoader::trim - " << usedBytes << " bytes in use, over the budget of " << memoryBudget << std::endl;
+}
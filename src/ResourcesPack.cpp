@@ -0,0 +1,234 @@
+#include "ResourcesPack.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <SDL.h>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+ResourcesPack::ResourcesPack() :
+	data(nullptr),
+	size(0),
+	header(nullptr),
+	index(nullptr)
+#ifdef _WIN32
+	, fileHandle(nullptr),
+	mappingHandle(nullptr)
+#endif
+{}
+
+ResourcesPack::~ResourcesPack() {
+	close();
+}
+
+bool ResourcesPack::open(const std::string& filename) {
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(file, &fileSize);
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (!view) {
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::runtime_error("[Error] ResourcesPack::open - failed to map " + filename);
+	}
+
+	fileHandle = file;
+	mappingHandle = mapping;
+	data = static_cast<const unsigned char*>(view);
+	size = (size_t)fileSize.QuadPart;
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		throw std::runtime_error("[Error] ResourcesPack::open - failed to stat " + filename);
+	}
+
+	void *view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping keeps its own reference to the file
+	if (view == MAP_FAILED)
+		throw std::runtime_error("[Error] ResourcesPack::open - failed to map " + filename);
+
+	data = static_cast<const unsigned char*>(view);
+	size = (size_t)st.st_size;
+#endif
+
+	// Validate the header and the index bounds once, lookups are unchecked afterwards
+	header = reinterpret_cast<const Pack::Header*>(data);
+	if (size < sizeof(Pack::Header) || header->magic != Pack::Magic || header->version != Pack::Version ||
+		header->indexSize == 0 || (header->indexSize & (header->indexSize - 1)) != 0 ||
+		header->indexOffset > size || header->indexSize > (size - header->indexOffset) / sizeof(Pack::IndexEntry)) {
+		close();
+		throw std::runtime_error("[Error] ResourcesPack::open - invalid pack " + filename);
+	}
+
+	index = reinterpret_cast<const Pack::IndexEntry*>(data + header->indexOffset);
+
+	for (uint32_t i = 0; i < header->indexSize; ++i) {
+		const Pack::IndexEntry &entry = index[i];
+		if (entry.id == Pack::EmptySlot)
+			continue;
+
+		// mecha_pack only writes RGBA32 pixels, a row must hold the width of the image
+		if (entry.format != SDL_PIXELFORMAT_RGBA32 || entry.width > INT32_MAX || entry.height > INT32_MAX || entry.pitch > INT32_MAX ||
+			entry.pitch < (uint64_t)entry.width * SDL_BYTESPERPIXEL(SDL_PIXELFORMAT_RGBA32)) {
+			close();
+			throw std::runtime_error("[Error] ResourcesPack::open - invalid entry in pack " + filename);
+		}
+
+		// The block must hold every row the entry describes, and lie within the file
+		if (entry.size < (uint64_t)entry.pitch * (uint64_t)entry.height || entry.offset > size || entry.size > size - entry.offset) {
+			close();
+			throw std::runtime_error("[Error] ResourcesPack::open - truncated pack " + filename);
+		}
+	}
+
+	return true;
+}
+
+void ResourcesPack::close() {
+	if (!data)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mappingHandle);
+	CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	munmap(const_cast<unsigned char*>(data), size);
+#endif
+
+	data = nullptr;
+	size = 0;
+	header = nullptr;
+	index = nullptr;
+}
+
+const Pack::IndexEntry* ResourcesPack::findSlot(uint32_t id) const {
+	const uint32_t mask = header->indexSize - 1;
+
+	// Linear probing, bounded by the table size in case a corrupt pack has no empty slot
+	uint32_t slot = Pack::hashID(id) & mask;
+	for (uint32_t probes = 0; probes < header->indexSize; ++probes, slot = (slot + 1) & mask) {
+		if (index[slot].id == id)
+			return &index[slot];
+		if (index[slot].id == Pack::EmptySlot)
+			return nullptr;
+	}
+
+	return nullptr;
+}
+
+bool ResourcesPack::find(Image::ID id, Entry& entry) const {
+	if (!data)
+		return false;
+
+	const Pack::IndexEntry *found = findSlot((uint32_t)id);
+	if (!found)
+		return false;
+
+	entry.format = found->format;
+	entry.width = (int)found->width;
+	entry.height = (int)found->height;
+	entry.pitch = (int)found->pitch;
+	entry.pixels = data + found->offset;
+
+	return true;
+}
+
+void ResourcesPackWriter::add(Image::ID id, uint32_t format, int width, int height, int pitch, const void *pixels) {
+	Asset asset;
+	asset.entry.id = (uint32_t)id;
+	asset.entry.format = format;
+	asset.entry.width = (uint32_t)width;
+	asset.entry.height = (uint32_t)height;
+	asset.entry.pitch = (uint32_t)pitch;
+	asset.entry.reserved = 0;
+	asset.entry.offset = 0;
+	asset.entry.size = (uint64_t)pitch * (uint64_t)height;
+
+	const unsigned char *bytes = static_cast<const unsigned char*>(pixels);
+	asset.pixels.assign(bytes, bytes + asset.entry.size);
+
+	assets.push_back(std::move(asset));
+}
+
+void ResourcesPackWriter::write(const std::string& filename) const {
+	// Keep the load factor under 1/2 so that probing stays short
+	uint32_t indexSize = 1;
+	while (indexSize < 2 * assets.size())
+		indexSize <<= 1;
+
+	Pack::Header header;
+	header.magic = Pack::Magic;
+	header.version = Pack::Version;
+	header.entryCount = (uint32_t)assets.size();
+	header.indexSize = indexSize;
+	header.indexOffset = sizeof(Pack::Header);
+
+	std::vector<Pack::IndexEntry> index(indexSize);
+	for (Pack::IndexEntry &slot : index) {
+		std::memset(&slot, 0, sizeof(slot));
+		slot.id = Pack::EmptySlot;
+	}
+
+	uint64_t offset = header.indexOffset + (uint64_t)indexSize * sizeof(Pack::IndexEntry);
+	std::vector<uint64_t> offsets;
+
+	for (const Asset &asset : assets) {
+		offset = (offset + 15) & ~(uint64_t)15;
+		offsets.push_back(offset);
+
+		uint32_t slot = Pack::hashID(asset.entry.id) & (indexSize - 1);
+		while (index[slot].id != Pack::EmptySlot) {
+			if (index[slot].id == asset.entry.id)
+				throw std::runtime_error("[Error] ResourcesPackWriter::write - duplicated image id");
+			slot = (slot + 1) & (indexSize - 1);
+		}
+
+		index[slot] = asset.entry;
+		index[slot].offset = offset;
+
+		offset += asset.entry.size;
+	}
+
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	if (!out)
+		throw std::runtime_error("[Error] ResourcesPackWriter::write - failed to open " + filename);
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(Pack::IndexEntry));
+
+	for (size_t i = 0; i < assets.size(); ++i) {
+		static const char padding[16] = {};
+		out.write(padding, (std::streamsize)(offsets[i] - (uint64_t)out.tellp()));
+		out.write(reinterpret_cast<const char*>(assets[i].pixels.data()), (std::streamsize)assets[i].pixels.size());
+	}
+
+	if (!out)
+		throw std::runtime_error("[Error] ResourcesPackWriter::write - failed to write " + filename);
+}
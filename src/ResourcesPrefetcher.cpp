@@ -0,0 +1,156 @@
+#include "ResourcesPrefetcher.hpp"
+
+#include <iostream>
+
+#include <SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include "ResourcesPack.hpp"
+#include "Utils/AllocTracker.hpp"
+#include "Utils/StartupTimeline.hpp"
+
+ResourcesPrefetcher::ResourcesPrefetcher(const ResourcesPack &pack) :
+	pack(pack),
+	stopping(false),
+	worker(&ResourcesPrefetcher::run, this)
+{}
+
+ResourcesPrefetcher::~ResourcesPrefetcher() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeUp.notify_one();
+	worker.join();
+
+	for (auto &result : done)
+		for (auto &surface : result.surfaces)
+			SDL_FreeSurface(surface.second);
+
+	for (auto &image : imagesDone)
+		if (image.second)
+			SDL_FreeSurface(image.second);
+}
+
+void ResourcesPrefetcher::request(Room::ID room) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!pending.insert(room).second)
+			return;
+		queue.push_back(room);
+	}
+	wakeUp.notify_one();
+}
+
+void ResourcesPrefetcher::requestImage(Image::ID img) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		imagesQueue.push_back(img);
+	}
+	wakeUp.notify_one();
+}
+
+bool ResourcesPrefetcher::isPending(Room::ID room) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending.count(room) != 0;
+}
+
+void ResourcesPrefetcher::wait(Room::ID room) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	finished.wait(lock, [this, room]() {
+		if (!pending.count(room))
+			return true;
+		for (auto &result : done)
+			if (result.room.id == room)
+				return true;
+		return false;
+	});
+}
+
+void ResourcesPrefetcher::collect(std::vector<Result>& results) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto &result : done) {
+		pending.erase(result.room.id);
+		results.push_back(std::move(result));
+	}
+	done.clear();
+}
+
+void ResourcesPrefetcher::collectImages(std::vector<std::pair<Image::ID, SDL_Surface*>>& images) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	images.insert(images.end(), imagesDone.begin(), imagesDone.end());
+	imagesDone.clear();
+}
+
+void ResourcesPrefetcher::run() {
+	MECHA_ALLOC_TAG(Resources);
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true) {
+		wakeUp.wait(lock, [this]() { return stopping || !queue.empty() || !imagesQueue.empty(); });
+		if (stopping)
+			return;
+
+		// Single images first, they are waited for by a running game
+		if (!imagesQueue.empty()) {
+			Image::ID img = imagesQueue.front();
+			imagesQueue.pop_front();
+
+			lock.unlock();
+			SDL_Surface *surface = IMG_Load(Image::fileName(img));
+			lock.lock();
+
+			imagesDone.push_back(std::make_pair(img, surface));
+			continue;
+		}
+
+		Room::ID room = queue.front();
+		queue.pop_front();
+
+		lock.unlock();
+		Result result(prefetch(room));
+		lock.lock();
+
+		done.push_back(std::move(result));
+		finished.notify_all();
+	}
+}
+
+ResourcesPrefetcher::Result ResourcesPrefetcher::prefetch(Room::ID room) const {
+	StartupTimeline::Stage stage("ResourcesPrefetcher::prefetch");
+
+	Result result;
+	result.room.id = room;
+	result.valid = false;
+
+	try {
+		result.valid = result.room.loadFromFile(room, Room::fileName(room));
+	} catch (std::exception &e) {
+		std::cerr << e.what() << std::endl;
+	}
+
+	if (!result.valid)
+		return result;
+
+	for (auto img : result.room.images) {
+		ResourcesPack::Entry entry;
+
+		if (pack.find(img, entry)) {
+			// Already decoded : fault the pages in now so that the upload does not wait on the disk
+			const volatile unsigned char *pixels = static_cast<const unsigned char*>(entry.pixels);
+			const size_t size = (size_t)entry.pitch * (size_t)entry.height;
+			for (size_t offset = 0; offset < size; offset += 4096)
+				(void)pixels[offset];
+		} else {
+			SDL_Surface *surface = IMG_Load(Image::fileName(img));
+			if (surface)
+				result.surfaces.push_back(std::make_pair(img, surface));
+		}
+	}
+
+	return result;
+}
@@ -8,27 +8,19 @@
 #include "ResourcesLoader.hpp"
 #include "ResourcesID.hpp"
 
-std::map<Image::ID, SDL_Rect> Sprite::srcRect;
-
 Sprite::Sprite(ResourcesLoader &rl, Image::ID id, int srcX, int srcY, int srcW, int srcH) :
-	resources(rl),
+	texture(rl, id),
+	frames(rl.defineFrames(id, { SDL_Rect{ srcX, srcY, srcW, srcH } })),
 	imgID(id)
 {
-	if (srcRect.find(id) == srcRect.end()) {
-		srcRect.insert(std::make_pair(id, SDL_Rect()));
-
-		srcRect[id].x = srcX; srcRect[id].y = srcY;
-		srcRect[id].w = srcW; srcRect[id].h = srcH;
-	}
-
 	dstRect.x = 0; dstRect.y = 0;
-	dstRect.w = srcW; dstRect.h = srcH;
-	
-	resources.load(imgID);
+	dstRect.w = frames[0].w; dstRect.h = frames[0].h;
 }
 
 Sprite::~Sprite() {}
 
 void Sprite::draw(const Painter& painter) const {
-	SDL_RenderCopy(painter.renderer, resources.get(imgID), &(srcRect[imgID]), &dstRect);
+	// The frame size may have changed since the construction (hot reload)
+	SDL_Rect dst = { dstRect.x, dstRect.y, frames[0].w, frames[0].h };
+	painter.copy(texture, frames[0], dst);
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "TextureHandle.hpp"
+
+#include "ResourcesLoader.hpp"
+
+TextureHandle::TextureHandle(ResourcesLoader &rl, Image::ID id) :
+	loader(&rl),
+	slot(rl.acquire(id))
+{}
+
+TextureHandle::TextureHandle(const TextureHandle& other) :
+	loader(other.loader),
+	slot(other.slot)
+{
+	if (slot)
+		slot->refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+TextureHandle::TextureHandle(TextureHandle&& other) :
+	loader(other.loader),
+	slot(other.slot)
+{
+	other.loader = nullptr;
+	other.slot = nullptr;
+}
+
+TextureHandle::~TextureHandle() {
+	release();
+}
+
+TextureHandle& TextureHandle::operator=(TextureHandle other) {
+	release();
+
+	loader = other.loader;
+	slot = other.slot;
+	other.loader = nullptr;
+	other.slot = nullptr;
+
+	return *this;
+}
+
+SDL_Texture* TextureHandle::get() const {
+	return loader->use(slot);
+}
+
+void TextureHandle::release() {
+	if (slot)
+		loader->release(slot);
+
+	loader = nullptr;
+	slot = nullptr;
+}
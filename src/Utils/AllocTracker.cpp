@@ -0,0 +1,169 @@
+#include "Utils/AllocTracker.hpp"
+
+#ifdef MECHA_ALLOC_TRACKER
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	// In front of each block, keeps the 16 bytes alignment of malloc
+	struct BlockHeader {
+		uint64_t size;
+		uint32_t tag;
+		uint32_t magic;
+	};
+	static_assert(sizeof(BlockHeader) == 16, "the header must keep the blocks aligned");
+
+	const uint32_t Magic = 0x4D414C43; // "MALC"
+
+	struct HotPathAllocation {
+		const char *hotPath;
+		AllocTracker::Tag tag;
+		size_t size;
+	};
+
+	// Plain atomics and PODs : constant initialized, usable by the allocations made before main
+	std::atomic<uint64_t> allocations[AllocTracker::TagsCount];
+	std::atomic<uint64_t> bytes[AllocTracker::TagsCount];
+	std::atomic<uint64_t> liveBytes, peakLiveBytes;
+
+	std::atomic<bool> steady;
+	std::atomic<uint64_t> hotPathAllocations;
+	HotPathAllocation recorded[16];
+
+	thread_local AllocTracker::Tag currentTag = AllocTracker::Untagged;
+	thread_local const char *currentHotPath = nullptr;
+}
+
+AllocTracker::Scope::Scope(Tag tag) :
+	previous(currentTag)
+{
+	currentTag = tag;
+}
+
+AllocTracker::Scope::~Scope() {
+	currentTag = previous;
+}
+
+AllocTracker::HotPath::HotPath(const char *name) :
+	previous(currentHotPath)
+{
+	currentHotPath = name;
+}
+
+AllocTracker::HotPath::~HotPath() {
+	currentHotPath = previous;
+}
+
+AllocTracker::Stats AllocTracker::takeStats() {
+	static uint64_t lastAllocations[TagsCount], lastBytes[TagsCount];
+
+	Stats stats;
+	for (int t = 0; t < TagsCount; t++) {
+		const uint64_t a = allocations[t].load(std::memory_order_relaxed);
+		const uint64_t b = bytes[t].load(std::memory_order_relaxed);
+
+		stats.allocations[t] = a - lastAllocations[t];
+		stats.bytes[t] = b - lastBytes[t];
+		lastAllocations[t] = a;
+		lastBytes[t] = b;
+	}
+
+	stats.liveBytes = liveBytes.load(std::memory_order_relaxed);
+	stats.peakLiveBytes = peakLiveBytes.load(std::memory_order_relaxed);
+	stats.hotPathAllocations = hotPathAllocations.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+uint64_t AllocTracker::getHotPathAllocations() {
+	return hotPathAllocations.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::setSteadyState() {
+	steady = true;
+}
+
+void AllocTracker::reportHotPathAllocations(std::ostream &out) {
+	const uint64_t count = getHotPathAllocations();
+	const uint64_t shown = count < 16 ? count : 16;
+
+	for (uint64_t i = 0; i < shown; i++)
+		out << "  " << recorded[i].hotPath << " (" << tagName(recorded[i].tag) << "): " << recorded[i].size << " bytes" << std::endl;
+	if (count > shown)
+		out << "  ... and " << count - shown << " more" << std::endl;
+}
+
+const char* AllocTracker::tagName(Tag tag) {
+	switch (tag) {
+	case Physics:
+		return "physics";
+	case Render:
+		return "render";
+	case Resources:
+		return "resources";
+	case Input:
+		return "input";
+	case Gameplay:
+		return "gameplay";
+	default:
+		return "untagged";
+	}
+}
+
+void* AllocTracker::allocate(size_t size, bool nothrow) {
+	BlockHeader *header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+	if (!header) {
+		if (nothrow)
+			return nullptr;
+		throw std::bad_alloc();
+	}
+
+	const Tag tag = currentTag;
+	header->size = size;
+	header->tag = tag;
+	header->magic = Magic;
+
+	allocations[tag].fetch_add(1, std::memory_order_relaxed);
+	bytes[tag].fetch_add(size, std::memory_order_relaxed);
+
+	const uint64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	uint64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+	while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+	if (currentHotPath && steady.load(std::memory_order_relaxed)) {
+		const uint64_t index = hotPathAllocations.fetch_add(1, std::memory_order_relaxed);
+		if (index < 16)
+			recorded[index] = HotPathAllocation{ currentHotPath, tag, size };
+	}
+
+	return header + 1;
+}
+
+void AllocTracker::release(void *p) {
+	if (!p)
+		return;
+
+	BlockHeader *header = static_cast<BlockHeader*>(p) - 1;
+	if (header->magic != Magic)
+		std::abort(); // Not allocated by the tracker, or already released
+
+	liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+	header->magic = 0;
+	std::free(header);
+}
+
+void* operator new(size_t size) { return AllocTracker::allocate(size, false); }
+void* operator new[](size_t size) { return AllocTracker::allocate(size, false); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return AllocTracker::allocate(size, true); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return AllocTracker::allocate(size, true); }
+
+void operator delete(void *p) noexcept { AllocTracker::release(p); }
+void operator delete[](void *p) noexcept { AllocTracker::release(p); }
+void operator delete(void *p, const std::nothrow_t&) noexcept { AllocTracker::release(p); }
+void operator delete[](void *p, const std::nothrow_t&) noexcept { AllocTracker::release(p); }
+void operator delete(void *p, size_t) noexcept { AllocTracker::release(p); }
+void operator delete[](void *p, size_t) noexcept { AllocTracker::release(p); }
+
+#endif
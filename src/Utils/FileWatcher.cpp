@@ -0,0 +1,103 @@
+#include "Utils/FileWatcher.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <sys/stat.h>
+
+#ifdef __linux__
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+namespace {
+	std::string directoryOf(const std::string& filename) {
+		size_t slash = filename.find_last_of('/');
+		return slash == std::string::npos ? "." : filename.substr(0, slash);
+	}
+}
+
+FileWatcher::FileWatcher() :
+	fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+	if (fd < 0)
+		std::cerr << "[Warning] FileWatcher - inotify is not available, files will not be watched" << std::endl;
+}
+
+FileWatcher::~FileWatcher() {
+	if (fd >= 0)
+		close(fd);
+}
+
+void FileWatcher::watch(const std::string& filename) {
+	if (fd < 0 || !files.insert(filename).second)
+		return;
+
+	const std::string directory(directoryOf(filename));
+	for (auto &kv : directories)
+		if (kv.second == directory)
+			return;
+
+	int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (wd < 0)
+		std::cerr << "[Warning] FileWatcher::watch - failed to watch " << directory << std::endl;
+	else
+		directories[wd] = directory;
+}
+
+void FileWatcher::poll(std::vector<std::string>& modified) {
+	if (fd < 0)
+		return;
+
+	alignas(struct inotify_event) char buffer[4096];
+	size_t first = modified.size();
+
+	ssize_t length;
+	while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+		for (char *ptr = buffer; ptr < buffer + length; ) {
+			const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(ptr);
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if (event->len == 0)
+				continue;
+
+			const std::string &directory = directories[event->wd];
+			const std::string filename(directory == "." ? std::string(event->name) : directory + "/" + event->name);
+
+			if (files.count(filename) && std::find(modified.begin() + first, modified.end(), filename) == modified.end())
+				modified.push_back(filename);
+		}
+	}
+}
+
+#else
+
+FileWatcher::FileWatcher() :
+	lastPoll(std::chrono::steady_clock::now())
+{}
+
+FileWatcher::~FileWatcher() {}
+
+void FileWatcher::watch(const std::string& filename) {
+	struct stat st;
+	files[filename] = (stat(filename.c_str(), &st) == 0) ? st.st_mtime : 0;
+}
+
+void FileWatcher::poll(std::vector<std::string>& modified) {
+	std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+	if (now - lastPoll < std::chrono::milliseconds(500))
+		return;
+	lastPoll = now;
+
+	for (auto &kv : files) {
+		struct stat st;
+		if (stat(kv.first.c_str(), &st) == 0 && st.st_mtime != kv.second) {
+			kv.second = st.st_mtime;
+			modified.push_back(kv.first);
+		}
+	}
+}
+
+#endif
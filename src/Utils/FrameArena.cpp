@@ -0,0 +1,61 @@
+#include "Utils/FrameArena.hpp"
+
+#include <algorithm>
+#include <stdint.h>
+
+namespace {
+	thread_local FrameArena *boundArena = nullptr;
+}
+
+FrameArena::FrameArena(size_t capacity) :
+	buffer(static_cast<unsigned char*>(::operator new(capacity))),
+	capacity(capacity),
+	used(0),
+	demand(0),
+	peak(0),
+	overflows(0)
+{}
+
+FrameArena::~FrameArena() {
+	::operator delete(buffer);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+	const uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+	const uintptr_t start = (base + used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	const size_t end = (size_t)(start - base) + bytes;
+
+	demand += bytes;
+
+	if (end > capacity) {
+		overflows++;
+		return nullptr;
+	}
+
+	used = end;
+	return reinterpret_cast<void*>(start);
+}
+
+void FrameArena::reset() {
+	// Lock-free maximum, peak being read by the thread reporting the statistics
+	size_t previous = peak.load();
+	while (demand > previous && !peak.compare_exchange_weak(previous, demand));
+
+	// Grown with some margin, so that a frame slightly bigger does not overflow again
+	if (demand > capacity) {
+		::operator delete(buffer);
+		capacity = demand + demand / 2;
+		buffer = static_cast<unsigned char*>(::operator new(capacity));
+	}
+
+	used = 0;
+	demand = 0;
+}
+
+FrameArena* FrameArena::current() {
+	return boundArena;
+}
+
+void FrameArena::bind(FrameArena* arena) {
+	boundArena = arena;
+}
@@ -0,0 +1,96 @@
+#include "Utils/FramePacer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#include <timeapi.h>
+#endif
+
+FramePacer::FramePacer(Mode mode) :
+	mode(mode),
+	// The Windows timer is raised to 1 ms below, a sleep may still overshoot by about that much
+	spinMargin(std::chrono::microseconds(1500)),
+	waits(0),
+	totalLateness(Clock::duration::zero()),
+	maxLateness(Clock::duration::zero()),
+	sleeping(Clock::duration::zero()),
+	statsStart(Clock::now())
+{
+#ifdef _WIN32
+	timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::waitUntil(const Clock::time_point& deadline) {
+	Clock::time_point now = Clock::now();
+	if (now >= deadline)
+		return;
+
+	switch (mode) {
+	case Spin:
+		break;
+	case Sleep:
+	case VSync:
+		if (deadline - now > spinMargin) {
+			std::this_thread::sleep_until(deadline - spinMargin);
+			sleeping += Clock::now() - now;
+		}
+		break;
+	case PowerSave:
+		std::this_thread::sleep_until(deadline);
+		sleeping += Clock::now() - now;
+		break;
+	}
+
+	while ((now = Clock::now()) < deadline)
+		std::this_thread::yield();
+
+	const Clock::duration lateness = now - deadline;
+	totalLateness += lateness;
+	maxLateness = std::max(maxLateness, lateness);
+	waits++;
+}
+
+FramePacer::JitterStats FramePacer::takeStats() {
+	typedef std::chrono::duration<float, std::micro> Microseconds;
+
+	const Clock::time_point now = Clock::now();
+	const Clock::duration period = now - statsStart;
+
+	JitterStats stats;
+	stats.waits = waits;
+	stats.meanLateness = waits ? Microseconds(totalLateness).count() / (float)waits : 0.f;
+	stats.maxLateness = Microseconds(maxLateness).count();
+	stats.sleepRatio = period.count() ? (float)sleeping.count() / (float)period.count() : 0.f;
+
+	waits = 0;
+	totalLateness = maxLateness = sleeping = Clock::duration::zero();
+	statsStart = now;
+
+	return stats;
+}
+
+FramePacer::Mode FramePacer::modeFromName(const std::string& name) {
+	if (name == "spin")
+		return Spin;
+	if (name == "sleep")
+		return Sleep;
+	if (name == "vsync")
+		return VSync;
+	if (name == "powersave")
+		return PowerSave;
+
+	throw std::runtime_error("[Error] FramePacer::modeFromName - unknown pacing mode " + name);
+}
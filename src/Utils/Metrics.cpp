@@ -0,0 +1,238 @@
+#include "Utils/Metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+	enum Type { CounterType, GaugeType, HistogramType };
+
+	const char* typeName(Type type) {
+		switch (type) {
+		case CounterType:
+			return "counter";
+		case GaugeType:
+			return "gauge";
+		default:
+			return "histogram";
+		}
+	}
+
+	// Highest value of the bucket holding the quantile q, the recorded max for the last one
+	uint64_t quantile(const uint64_t *counts, uint64_t total, uint64_t max, double q) {
+		const uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+
+		uint64_t seen = 0;
+		for (unsigned int b = 0; b < Metrics::Histogram::Buckets - 1; b++) {
+			seen += counts[b];
+			if (seen >= rank && seen)
+				return std::min(Metrics::Histogram::bucketValue(b + 1) - 1, max);
+		}
+
+		return max;
+	}
+}
+
+struct Metrics::Registry {
+	Registry() : start(std::chrono::steady_clock::now()) {}
+
+	struct Entry {
+		Type type;
+		void *metric;
+	};
+
+	template<typename T>
+	T& find(const std::string& name, Type type, std::deque<T>& storage) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto found = entries.find(name);
+		if (found != entries.end()) {
+			if (found->second.type != type)
+				throw std::runtime_error(std::string("[Error] Metrics::") + typeName(type) + " - " + name + " is already a " + typeName(found->second.type));
+			return *static_cast<T*>(found->second.metric);
+		}
+
+		// A deque never moves its elements, the references stay valid
+		storage.emplace_back();
+		entries[name] = Entry{ type, &storage.back() };
+		return storage.back();
+	}
+
+	std::mutex mutex;
+	std::chrono::steady_clock::time_point start;
+
+	std::map<std::string, Entry> entries;  // Sorted by name, the order of the snapshots
+	std::deque<Counter> counters;
+	std::deque<Gauge> gauges;
+	std::deque<Histogram> histograms;
+};
+
+Metrics::Counter::Counter() {
+	for (auto &slot : slots)
+		slot.value = 0;
+}
+
+uint64_t Metrics::Counter::value() const {
+	uint64_t v = 0;
+	for (auto &slot : slots)
+		v += slot.value.load(std::memory_order_relaxed);
+	return v;
+}
+
+Metrics::Histogram::Histogram() :
+	total(0),
+	sum(0),
+	max(0)
+{
+	for (auto &count : counts)
+		count = 0;
+}
+
+void Metrics::Histogram::record(uint64_t value) {
+	counts[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+	total.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t previous = max.load(std::memory_order_relaxed);
+	while (value > previous && !max.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {}
+}
+
+Metrics::Histogram::Summary Metrics::Histogram::take() {
+	// A value recorded meanwhile may be counted in this summary or the next one, never lost
+	uint64_t snapshot[Buckets];
+	for (unsigned int b = 0; b < Buckets; b++)
+		snapshot[b] = counts[b].exchange(0, std::memory_order_relaxed);
+
+	Summary summary;
+	summary.count = total.exchange(0, std::memory_order_relaxed);
+	summary.max = max.exchange(0, std::memory_order_relaxed);
+	const uint64_t valuesSum = sum.exchange(0, std::memory_order_relaxed);
+	summary.mean = summary.count ? (double)valuesSum / (double)summary.count : 0.;
+
+	summary.p50 = quantile(snapshot, summary.count, summary.max, 0.5);
+	summary.p90 = quantile(snapshot, summary.count, summary.max, 0.9);
+	summary.p99 = quantile(snapshot, summary.count, summary.max, 0.99);
+
+	return summary;
+}
+
+uint64_t Metrics::Histogram::bucketValue(unsigned int bucket) {
+	if (bucket < SubBuckets)
+		return bucket;
+
+	const unsigned int exponent = bucket / SubBuckets + 3;
+	return (uint64_t)(SubBuckets + bucket % SubBuckets) << (exponent - 4);
+}
+
+unsigned int Metrics::Histogram::bucketOf(uint64_t value) {
+	if (value < SubBuckets)
+		return (unsigned int)value;
+	if (value >> 32)
+		return Buckets - 1;
+
+	unsigned int exponent = 4;
+	while (value >> (exponent + 1))
+		exponent++;
+
+	// The 4 bits under the highest one select the sub bucket
+	return (exponent - 3) * SubBuckets + (unsigned int)((value >> (exponent - 4)) & (SubBuckets - 1));
+}
+
+Metrics::Registry& Metrics::registry() {
+	static Registry instance;
+	return instance;
+}
+
+Metrics::Counter& Metrics::counter(const std::string& name) {
+	return registry().find(name, CounterType, registry().counters);
+}
+
+Metrics::Gauge& Metrics::gauge(const std::string& name) {
+	return registry().find(name, GaugeType, registry().gauges);
+}
+
+Metrics::Histogram& Metrics::histogram(const std::string& name) {
+	return registry().find(name, HistogramType, registry().histograms);
+}
+
+void Metrics::takeSnapshot(Snapshot& snapshot) {
+	Registry &r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+
+	snapshot.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - r.start).count();
+	snapshot.values.clear();
+
+	for (auto &entry : r.entries) {
+		Snapshot::Value value = {};
+		value.name = &entry.first;
+		value.type = typeName(entry.second.type);
+		value.histogram = entry.second.type == HistogramType;
+
+		switch (entry.second.type) {
+		case CounterType:
+			value.value = (int64_t)static_cast<Counter*>(entry.second.metric)->value();
+			break;
+		case GaugeType:
+			value.value = static_cast<Gauge*>(entry.second.metric)->value();
+			break;
+		case HistogramType:
+			value.summary = static_cast<Histogram*>(entry.second.metric)->take();
+			break;
+		}
+
+		snapshot.values.push_back(value);
+	}
+}
+
+bool Metrics::writeSnapshot(const Snapshot& snapshot, const std::string& filename) {
+	const bool json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+	const bool header = !json && !std::ifstream(filename);
+
+	std::ofstream out(filename, std::ios::app);
+	if (!out)
+		return false;
+
+	if (header)
+		out << "time,name,type,value,count,mean,p50,p90,p99,max\n";
+	if (json)
+		out << "{\"time\":" << snapshot.time << ",\"metrics\":{";
+
+	bool first = true;
+	for (auto &value : snapshot.values) {
+		if (json) {
+			out << (first ? "" : ",") << '"' << *value.name << "\":";
+			first = false;
+		} else {
+			out << snapshot.time << ',' << *value.name << ',' << value.type << ',';
+		}
+
+		if (value.histogram) {
+			const Histogram::Summary &s = value.summary;
+			if (json)
+				out << "{\"count\":" << s.count << ",\"mean\":" << s.mean << ",\"p50\":" << s.p50 << ",\"p90\":" << s.p90
+					<< ",\"p99\":" << s.p99 << ",\"max\":" << s.max << '}';
+			else
+				out << ',' << s.count << ',' << s.mean << ',' << s.p50 << ',' << s.p90 << ',' << s.p99 << ',' << s.max;
+		} else {
+			out << value.value << (json ? "" : ",,,,,,");
+		}
+
+		if (!json)
+			out << '\n';
+	}
+
+	if (json)
+		out << "}}\n";
+
+	return (bool)out;
+}
+
+bool Metrics::writeSnapshot(const std::string& filename) {
+	Snapshot snapshot;
+	takeSnapshot(snapshot);
+	return writeSnapshot(snapshot, filename);
+}
@@ -0,0 +1,111 @@
+#include "Utils/Profiler.hpp"
+
+#ifdef MECHA_PROFILER
+
+#include <fstream>
+#include <mutex>
+
+// One per thread, never freed : a dump may still read the buffer of a thread which exited
+struct Profiler::ThreadBuffer {
+	ThreadBuffer() : events(BufferSize), written(0), id(0), name("Thread") {}
+
+	std::vector<Event> events;
+	std::atomic<uint64_t> written;      // Events recorded since the start, the next one goes to written % BufferSize
+	unsigned int id;
+	std::string name;
+};
+
+namespace {
+	std::mutex buffersMutex;
+
+	// Events of the oldest part of a ring left out of a dump, as the thread may be overwriting them
+	const uint64_t DumpMargin = 1024;
+}
+
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>>& Profiler::allBuffers() {
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	return buffers;
+}
+
+Profiler::ThreadBuffer& Profiler::buffer() {
+	thread_local ThreadBuffer *local = nullptr;
+
+	if (!local) {
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		allBuffers().emplace_back(new ThreadBuffer());
+		local = allBuffers().back().get();
+		local->id = (unsigned int)allBuffers().size();
+	}
+
+	return *local;
+}
+
+void Profiler::record(const char *name, const Clock::time_point& start, const Clock::time_point& end) {
+	ThreadBuffer &b = buffer();
+	const uint64_t index = b.written.load(std::memory_order_relaxed);
+
+	Event &e = b.events[index % BufferSize];
+	e.name = name;
+	e.start = start;
+	e.end = end;
+
+	// Published after the event is complete
+	b.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char *name) {
+	ThreadBuffer &b = buffer();
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	b.name = name;
+}
+
+bool Profiler::dump(const std::string& filename) {
+	typedef std::chrono::duration<double, std::micro> Microseconds;
+
+	std::ofstream out(filename);
+	if (!out)
+		return false;
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	// The timestamps are relative to the oldest event, so that they stay readable
+	Clock::time_point origin = Clock::time_point::max();
+	std::vector<std::vector<Event>> snapshots;
+
+	for (auto &b : allBuffers()) {
+		const uint64_t written = b->written.load(std::memory_order_acquire);
+		const uint64_t kept = written < BufferSize - DumpMargin ? written : BufferSize - DumpMargin;
+
+		snapshots.emplace_back();
+		std::vector<Event> &events = snapshots.back();
+		events.reserve((size_t)kept);
+
+		for (uint64_t i = written - kept; i < written; ++i)
+			events.push_back(b->events[i % BufferSize]);
+
+		if (!events.empty() && events.front().start < origin)
+			origin = events.front().start;
+	}
+
+	out << "{\"traceEvents\":[\n";
+	bool first = true;
+
+	for (size_t t = 0; t < snapshots.size(); ++t) {
+		const ThreadBuffer &b = *allBuffers()[t];
+
+		out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b.id
+			<< ",\"args\":{\"name\":\"" << b.name << "\"}}";
+		first = false;
+
+		for (auto &e : snapshots[t]) {
+			out << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b.id
+				<< ",\"ts\":" << Microseconds(e.start - origin).count() << ",\"dur\":" << Microseconds(e.end - e.start).count() << "}";
+		}
+	}
+
+	out << "\n]}\n";
+	return (bool)out;
+}
+
+#endif
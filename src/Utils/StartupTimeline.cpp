@@ -0,0 +1,104 @@
+#include "Utils/StartupTimeline.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utils/Metrics.hpp"
+
+namespace {
+	typedef std::chrono::steady_clock Clock;
+	typedef std::chrono::duration<float, std::milli> Milliseconds;
+
+	struct Record {
+		const char *name;
+		float start;            // Milliseconds since the origin
+		float duration;
+		unsigned int depth;     // Stages of the same thread enclosing this one
+		bool mainThread;
+	};
+
+	// Initialized before main, on the main thread : the closest to the start of the process
+	const Clock::time_point origin = Clock::now();
+	const std::thread::id mainThread = std::this_thread::get_id();
+
+	std::mutex mutex;
+	std::vector<Record> records;
+	std::atomic<bool> over(false);
+	Clock::duration timeToFirstFrame = Clock::duration::zero();
+
+	thread_local unsigned int currentDepth = 0;
+}
+
+StartupTimeline::Stage::Stage(const char *name) :
+	name(name),
+	start(Clock::now()),
+	depth(currentDepth),
+	recorded(!over.load(std::memory_order_relaxed))
+{
+	currentDepth++;
+}
+
+StartupTimeline::Stage::~Stage() {
+	currentDepth--;
+
+	// Stages of the running game are not part of the startup
+	if (!recorded || over.load(std::memory_order_relaxed))
+		return;
+
+	const Clock::time_point end = Clock::now();
+	std::lock_guard<std::mutex> lock(mutex);
+	records.push_back(Record{ name, Milliseconds(start - origin).count(), Milliseconds(end - start).count(), depth, std::this_thread::get_id() == mainThread });
+}
+
+void StartupTimeline::firstFrame() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (over)
+		return;
+
+	timeToFirstFrame = Clock::now() - origin;
+	over = true;
+
+	Metrics::gauge("startup.first_frame_us").set((int64_t)std::chrono::duration_cast<std::chrono::microseconds>(timeToFirstFrame).count());
+}
+
+bool StartupTimeline::isOver() {
+	return over;
+}
+
+std::chrono::duration<float> StartupTimeline::getTimeToFirstFrame() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return timeToFirstFrame;
+}
+
+void StartupTimeline::report(std::ostream& out) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::vector<Record> sorted(records);
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Record& a, const Record& b) { return a.start < b.start; });
+
+	// The main thread time outside of any stage : what is not instrumented yet
+	float staged = 0.f;
+	for (auto &record : sorted)
+		if (record.mainThread && !record.depth)
+			staged += record.duration;
+	const float total = Milliseconds(timeToFirstFrame).count();
+
+	const std::ios::fmtflags flags = out.flags();
+	const std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(1);
+
+	out << "Startup: first frame after " << total << " ms" << std::endl;
+	out << std::setw(12) << "start" << std::setw(12) << "duration" << "  stage" << std::endl;
+	for (auto &record : sorted) {
+		out << std::setw(9) << record.start << " ms " << std::setw(9) << record.duration << " ms  "
+			<< std::string(record.depth * 2, ' ') << record.name << (record.mainThread ? "" : " (worker)") << std::endl;
+	}
+	out << "  " << std::max(total - staged, 0.f) << " ms of the main thread outside the stages" << std::endl;
+
+	out.flags(flags);
+	out.precision(precision);
+}
@@ -0,0 +1,68 @@
+#include "World/RoomData.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+bool RoomData::loadFromFile(Room::ID roomID, const std::string& filename) {
+	std::ifstream file(filename);
+	if (!file)
+		return false;
+
+	id = roomID;
+	bounds.x = 0; bounds.y = 0;
+	bounds.w = 0; bounds.h = 0;
+	images.clear();
+	doors.clear();
+	solids.clear();
+	enemies.clear();
+
+	std::string line;
+	for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+		std::istringstream in(line);
+		std::string keyword;
+
+		if (!(in >> keyword) || keyword[0] == '#')
+			continue;
+
+		if (keyword == "bounds") {
+			in >> bounds.x >> bounds.y >> bounds.w >> bounds.h;
+		} else if (keyword == "image") {
+			int img = -1;
+			in >> img;
+			if (img < 0 || img >= Image::Count)
+				throw std::runtime_error("[Error] RoomData::loadFromFile - unknown image in " + filename + ":" + std::to_string(lineNumber));
+			images.push_back((Image::ID)img);
+		} else if (keyword == "door") {
+			Door door;
+			in >> door.target >> door.area.x >> door.area.y >> door.area.w >> door.area.h;
+			doors.push_back(door);
+		} else if (keyword == "solid") {
+			SDL_Rect solid;
+			in >> solid.x >> solid.y >> solid.w >> solid.h;
+			solids.push_back(solid);
+		} else if (keyword == "enemy") {
+			EnemyPlacement enemy;
+			std::string behaviour;
+			in >> behaviour >> enemy.position.x >> enemy.position.y >> enemy.speed >> enemy.range;
+
+			if (behaviour == "idle")
+				enemy.behaviour = ECS::AI::Idle;
+			else if (behaviour == "patrol")
+				enemy.behaviour = ECS::AI::Patrol;
+			else if (behaviour == "chase")
+				enemy.behaviour = ECS::AI::Chase;
+			else
+				throw std::runtime_error("[Error] RoomData::loadFromFile - unknown behaviour " + behaviour + " in " + filename + ":" + std::to_string(lineNumber));
+
+			enemies.push_back(enemy);
+		} else {
+			throw std::runtime_error("[Error] RoomData::loadFromFile - unknown keyword " + keyword + " in " + filename + ":" + std::to_string(lineNumber));
+		}
+
+		if (in.fail())
+			throw std::runtime_error("[Error] RoomData::loadFromFile - malformed line " + filename + ":" + std::to_string(lineNumber));
+	}
+
+	return true;
+}
@@ -0,0 +1,157 @@
+#include "World/Spawner.hpp"
+
+#include "Animation/AnimationSystem.hpp"
+#include "MPhysac/MPhysacWorld.hpp"
+
+Spawner::Spawner(ECS::Registry& registry, AnimationSystem& animations, const Capacities& capacities) :
+	registry(registry),
+	animations(animations),
+	projectiles(capacities.projectiles),
+	particles(capacities.particles),
+	enemies(capacities.enemies)
+{
+	const size_t total = capacities.projectiles + capacities.particles + capacities.enemies;
+
+	registry.reserve(total);
+	animations.reserve(animations.getStatesCount() + total);
+
+	// Sized for every entity of the registry, the sparse arrays being indexed by entity
+	const size_t entities = registry.capacity();
+	registry.pool<ECS::Transform>().reserve(entities);
+	registry.pool<ECS::Sprite>().reserve(entities);
+	registry.pool<ECS::PhysicsHandle>().reserve(entities);
+	registry.pool<ECS::Vitals>().reserve(entities);
+	registry.pool<ECS::AI>().reserve(entities);
+	registry.pool<ECS::Asleep>().reserve(entities);
+
+	for (auto &sprite : sprites)
+		sprite.enabled = false;
+}
+
+void Spawner::setSprite(Kind kind, ResourcesLoader& rl, Animation::ID clip) {
+	sprites[kind].texture = TextureHandle(rl, animations.getClip(clip).image);
+	sprites[kind].clip = clip;
+	sprites[kind].enabled = true;
+}
+
+ECS::Entity Spawner::create(Kind kind, const Vector2f& position, const Vector2f& velocity) {
+	const ECS::Entity entity = registry.create();
+	registry.assign<ECS::Transform>(entity, position, velocity);
+
+	const SpriteKind &sprite = sprites[kind];
+	if (sprite.enabled)
+		registry.assign<ECS::Sprite>(entity, sprite.texture, animations.create(sprite.clip));
+
+	return entity;
+}
+
+Spawner::ProjectileHandle Spawner::spawnProjectile(const Vector2f& position, const Vector2f& velocity, float lifetime) {
+	if (projectiles.full())
+		return ProjectileHandle();
+
+	return projectiles.create(Projectile{ create(Projectiles, position, velocity), lifetime });
+}
+
+Spawner::ParticleHandle Spawner::spawnParticle(const Vector2f& position, const Vector2f& velocity, float lifetime) {
+	if (particles.full())
+		return ParticleHandle();
+
+	return particles.create(Particle{ create(Particles, position, velocity), lifetime });
+}
+
+Spawner::EnemyHandle Spawner::spawnEnemy(const Vector2f& position, ECS::AI::Behaviour behaviour, float speed, float range) {
+	if (enemies.full())
+		return EnemyHandle();
+
+	const ECS::Entity entity = create(Enemies, position, Vector2f());
+	registry.assign<ECS::Vitals>(entity, 3, 100);
+	registry.assign<ECS::AI>(entity, behaviour, speed, range, position);
+
+	// Kinematic enemy if the bodies pool is full
+	attachEnemyBody(entity);
+
+	return enemies.create(Enemy{ entity });
+}
+
+bool Spawner::attachEnemyBody(ECS::Entity entity) {
+	const ECS::Transform &transform = registry.get<ECS::Transform>(entity);
+
+	MPhysacBody *body = MPhysacWorld::getInstance().CreatePhysicsBodyRectangle(transform.position, 32.f, 32.f, 1.f);
+	if (!body)
+		return false;
+
+	body->useGravity = false;
+	body->freezeOrient = true;
+	body->velocity = transform.velocity;
+	registry.assign<ECS::PhysicsHandle>(entity, body);
+
+	return true;
+}
+
+void Spawner::despawn(const ProjectileHandle& handle) {
+	if (Projectile *projectile = projectiles.get(handle)) {
+		registry.destroy(projectile->entity);
+		projectiles.destroy(handle);
+	}
+}
+
+void Spawner::despawn(const ParticleHandle& handle) {
+	if (Particle *particle = particles.get(handle)) {
+		registry.destroy(particle->entity);
+		particles.destroy(handle);
+	}
+}
+
+void Spawner::despawn(const EnemyHandle& handle) {
+	if (Enemy *enemy = enemies.get(handle)) {
+		registry.destroy(enemy->entity);
+		enemies.destroy(handle);
+	}
+}
+
+void Spawner::update(float dt) {
+	// Backwards : destroying the item at i moves the last one, already visited, to i
+	for (size_t i = projectiles.size(); i > 0; --i) {
+		Projectile &projectile = projectiles.at(i - 1);
+		projectile.lifetime -= dt;
+
+		if (projectile.lifetime <= 0.f || !registry.valid(projectile.entity)) {
+			registry.destroy(projectile.entity);
+			projectiles.destroy(&projectile);
+		}
+	}
+
+	for (size_t i = particles.size(); i > 0; --i) {
+		Particle &particle = particles.at(i - 1);
+		particle.lifetime -= dt;
+
+		if (particle.lifetime <= 0.f || !registry.valid(particle.entity)) {
+			registry.destroy(particle.entity);
+			particles.destroy(&particle);
+		}
+	}
+
+	for (size_t i = enemies.size(); i > 0; --i) {
+		Enemy &enemy = enemies.at(i - 1);
+		if (!registry.valid(enemy.entity))
+			enemies.destroy(&enemy);
+	}
+}
+
+size_t Spawner::getCount(Kind kind) const {
+	switch (kind) {
+	case Projectiles: return projectiles.size();
+	case Particles: return particles.size();
+	case Enemies: return enemies.size();
+	default: return 0;
+	}
+}
+
+size_t Spawner::getCapacity(Kind kind) const {
+	switch (kind) {
+	case Projectiles: return projectiles.capacity();
+	case Particles: return particles.capacity();
+	case Enemies: return enemies.capacity();
+	default: return 0;
+	}
+}
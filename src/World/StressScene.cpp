@@ -0,0 +1,297 @@
+#include "World/StressScene.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "ResourcesLoader.hpp"
+#include "MPhysac/MPhysacWorld.hpp"
+
+namespace {
+	// Ticks between a step and its measure, the new bodies fall and pile up meanwhile
+	const unsigned int SettleTicks = 15;
+	// Ticks averaged by the measure of a step
+	const unsigned int MeasureTicks = 30;
+
+	const float WallThickness = 20.f;
+
+	enum BodyKind { Box, Circle, Polygon };
+
+	unsigned int total(const StressScene::Mix& mix) {
+		return mix.boxes + mix.circles + mix.polygons + mix.sprites + mix.enemies;
+	}
+}
+
+StressScene::StressScene(ECS::Registry& registry, Spawner& spawner, ResourcesLoader& rl, const Mix& mix, const SDL_Rect& area, float budgetMs) :
+	registry(registry),
+	spawner(spawner),
+	area(area),
+	budget(budgetMs),
+	current(0),
+	ticks(0),
+	costSum(0.f),
+	population(0),
+	random(1)
+{
+	if (!total(mix))
+		throw std::runtime_error("[Error] StressScene::StressScene - the mix spawns nothing");
+
+	const Mix none = { 0, 0, 0, 0, 0 };
+	const struct {
+		const char *name;
+		unsigned int Mix::*count;
+	} kinds[] = {
+		{ "boxes", &Mix::boxes },
+		{ "circles", &Mix::circles },
+		{ "polygons", &Mix::polygons },
+		{ "sprites", &Mix::sprites },
+		{ "enemies", &Mix::enemies },
+	};
+
+	unsigned int kindsCount = 0;
+	for (auto &kind : kinds) {
+		if (!(mix.*kind.count))
+			continue;
+
+		Phase phase = { kind.name, none, 0, 0.f, 0, 0.f, false };
+		phase.mix.*kind.count = mix.*kind.count;
+		phases.push_back(phase);
+		kindsCount++;
+	}
+
+	if (kindsCount > 1)
+		phases.push_back(Phase{ "mix", mix, 0, 0.f, 0, 0.f, false });
+
+	spawner.setSprite(Spawner::Particles, rl, Animation::Player);
+
+	createWalls();
+	spawnStep(phases[current].mix);
+}
+
+StressScene::~StressScene() {
+	clear();
+}
+
+bool StressScene::update(float costMs) {
+	if (isOver())
+		return false;
+
+	if (++ticks <= SettleTicks)
+		return true;
+
+	costSum += costMs;
+	if (ticks < SettleTicks + MeasureTicks)
+		return true;
+
+	Phase &phase = phases[current];
+	const float cost = costSum / (float)MeasureTicks;
+	const bool overBudget = cost > budget;
+
+	if (!overBudget) {
+		phase.sustained = population;
+		phase.cost = cost;
+	} else {
+		phase.overPopulation = population;
+		phase.overCost = cost;
+	}
+
+	ticks = 0;
+	costSum = 0.f;
+
+	// Next step of the ramp
+	if (!overBudget) {
+		if (spawnStep(phase.mix))
+			return true;
+		phase.capped = true;
+	}
+
+	clear();
+	if (++current >= phases.size())
+		return false;
+
+	createWalls();
+	spawnStep(phases[current].mix);
+	return true;
+}
+
+void StressScene::report(std::ostream& out) const {
+	out << "Stress (budget " << budget << " ms per tick):" << std::endl;
+
+	for (size_t i = 0; i < phases.size(); i++) {
+		const Phase &phase = phases[i];
+		out << "  " << phase.name << ": ";
+
+		if (i > current || (i == current && !phase.sustained)) {
+			out << "not measured" << std::endl;
+			continue;
+		}
+
+		if (!phase.sustained)
+			out << "over budget from the first step";
+		else
+			out << (phase.capped ? ">=" : "") << phase.sustained << " entities at " << phase.cost << " ms";
+
+		if (phase.capped)
+			out << " (pools full)";
+		else if (phase.overPopulation)
+			out << " (" << phase.overPopulation << " at " << phase.overCost << " ms)";
+		else
+			out << " (unfinished)";
+		out << std::endl;
+	}
+}
+
+bool StressScene::spawnStep(const Mix& mix) {
+	for (unsigned int i = 0; i < mix.boxes; i++)
+		if (!spawnBody(Box))
+			return false;
+	for (unsigned int i = 0; i < mix.circles; i++)
+		if (!spawnBody(Circle))
+			return false;
+	for (unsigned int i = 0; i < mix.polygons; i++)
+		if (!spawnBody(Polygon))
+			return false;
+
+	std::uniform_real_distribution<float> speed(-64.f, 64.f);
+
+	for (unsigned int i = 0; i < mix.sprites; i++) {
+		const Spawner::ParticleHandle handle = spawner.spawnParticle(randomPosition(), Vector2f(speed(random), speed(random)), 1e9f);
+		if (handle.isNull())
+			return false;
+		sprites.push_back(handle);
+		population++;
+	}
+
+	std::uniform_int_distribution<int> behaviour(ECS::AI::Idle, ECS::AI::Chase);
+
+	for (unsigned int i = 0; i < mix.enemies; i++) {
+		const Spawner::EnemyHandle handle = spawner.spawnEnemy(randomPosition(), (ECS::AI::Behaviour)behaviour(random), 64.f, 256.f);
+		// Also full once the bodies pool is
+		if (handle.isNull() || !registry.has<ECS::PhysicsHandle>(spawner.getEntity(handle))) {
+			spawner.despawn(handle);
+			return false;
+		}
+		enemies.push_back(handle);
+		population++;
+	}
+
+	return true;
+}
+
+bool StressScene::spawnBody(unsigned int kind) {
+	MPhysacWorld &world = MPhysacWorld::getInstance();
+	const Vector2f position = randomPosition();
+	MPhysacBody *body = nullptr;
+
+	switch (kind) {
+	case Box: {
+		std::uniform_real_distribution<float> size(8.f, 24.f);
+		body = world.CreatePhysicsBodyRectangle(position, size(random), size(random), 1.f);
+	} break;
+	case Circle: {
+		std::uniform_real_distribution<float> radius(4.f, 12.f);
+		body = world.CreatePhysicsBodyCircle(position, radius(random), 1.f);
+	} break;
+	case Polygon: {
+		// Regular polygons : despite its name, PolygonData::CreateRandomPolygon spreads the vertices evenly on the circle
+		std::uniform_real_distribution<float> radius(8.f, 16.f);
+		std::uniform_int_distribution<int> sides(3, 8);
+		body = world.CreatePhysicsBodyPolygon(position, radius(random), sides(random), 1.f);
+	} break;
+	}
+
+	if (!body)
+		return false;
+
+	const ECS::Entity entity = registry.create();
+	registry.assign<ECS::Transform>(entity, position, Vector2f());
+	registry.assign<ECS::PhysicsHandle>(entity, body);
+	entities.push_back(entity);
+	population++;
+
+	return true;
+}
+
+void StressScene::createWalls() {
+	MPhysacWorld &world = MPhysacWorld::getInstance();
+
+	const float x = (float)area.x, y = (float)area.y, w = (float)area.w, h = (float)area.h;
+	const Vector2f centers[] = {
+		Vector2f(x + w / 2.f, y + h), Vector2f(x + w / 2.f, y),
+		Vector2f(x, y + h / 2.f), Vector2f(x + w, y + h / 2.f)
+	};
+	const Vector2f sizes[] = {
+		Vector2f(w, WallThickness), Vector2f(w, WallThickness),
+		Vector2f(WallThickness, h), Vector2f(WallThickness, h)
+	};
+
+	for (int i = 0; i < 4; i++) {
+		MPhysacBody *wall = world.CreatePhysicsBodyRectangle(centers[i], sizes[i].x, sizes[i].y, 10.f);
+		if (!wall)
+			return;
+
+		wall->enabled = false;
+		wall->useGravity = false;
+		wall->solidType = MPHYSAC_GROUND;
+
+		const ECS::Entity entity = registry.create();
+		registry.assign<ECS::Transform>(entity, centers[i], Vector2f());
+		registry.assign<ECS::PhysicsHandle>(entity, wall);
+		entities.push_back(entity);
+	}
+}
+
+void StressScene::clear() {
+	// The bodies are destroyed with their PhysicsHandle
+	for (auto entity : entities)
+		registry.destroy(entity);
+	for (auto &handle : sprites)
+		spawner.despawn(handle);
+	for (auto &handle : enemies)
+		spawner.despawn(handle);
+
+	entities.clear();
+	sprites.clear();
+	enemies.clear();
+	population = 0;
+}
+
+Vector2f StressScene::randomPosition() {
+	const float margin = WallThickness * 2.f;
+	std::uniform_real_distribution<float> x((float)area.x + margin, (float)(area.x + area.w) - margin);
+	std::uniform_real_distribution<float> y((float)area.y + margin, (float)(area.y + area.h) - margin);
+	return Vector2f(x(random), y(random));
+}
+
+StressScene::Mix StressScene::parseMix(const std::string& text) {
+	Mix mix = { 0, 0, 0, 0, 0 };
+
+	std::istringstream in(text);
+	std::string item;
+	while (std::getline(in, item, ',')) {
+		const size_t colon = item.find(':');
+		std::istringstream countIn(colon == std::string::npos ? std::string() : item.substr(colon + 1));
+		unsigned int count;
+		if (!(countIn >> count) || !countIn.eof())
+			throw std::runtime_error("[Error] StressScene::parseMix - expected <kind>:<count> in " + item);
+
+		const std::string kind(item.substr(0, colon));
+		if (kind == "boxes")
+			mix.boxes = count;
+		else if (kind == "circles")
+			mix.circles = count;
+		else if (kind == "polygons")
+			mix.polygons = count;
+		else if (kind == "sprites")
+			mix.sprites = count;
+		else if (kind == "enemies")
+			mix.enemies = count;
+		else
+			throw std::runtime_error("[Error] StressScene::parseMix - unknown kind " + kind);
+	}
+
+	return mix;
+}
+
+StressScene::Mix StressScene::defaultMix() {
+	return Mix{ 32, 32, 16, 128, 8 };
+}
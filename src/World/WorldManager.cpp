@@ -0,0 +1,211 @@
+#include "World/WorldManager.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "ECS/Systems.hpp"
+#include "MPhysac/MPhysacBody.hpp"
+
+WorldManager::WorldManager(ECS::Registry& registry, Spawner& spawner, unsigned int nearbyPeriod) :
+	registry(registry),
+	spawner(spawner),
+	nearbyPeriod(std::max(nearbyPeriod, 1u)),
+	ticks(0),
+	nearbyDt(0.f),
+	hasPending(false),
+	roomsCount(0),
+	activeCount(0),
+	nearbyCount(0),
+	storedCount(0)
+{}
+
+void WorldManager::enterRoom(const RoomData& current, const std::vector<const RoomData*>& adjacent) {
+	std::lock_guard<std::mutex> lock(pendingMutex);
+
+	pendingRoom = current;
+	pendingAdjacent.clear();
+	for (auto room : adjacent)
+		pendingAdjacent.push_back(*room);
+
+	hasPending = true;
+}
+
+void WorldManager::update(float dt, const Vector2f& target) {
+	if (hasPending)
+		applyPending();
+
+	// The asleep entities catch up with the time skipped, at a coarser step
+	nearbyDt += dt;
+	if (++ticks % nearbyPeriod == 0) {
+		ECS::updateAsleep(registry, target, nearbyDt);
+		nearbyDt = 0.f;
+	}
+}
+
+void WorldManager::applyPending() {
+	std::lock_guard<std::mutex> lock(pendingMutex);
+	hasPending = false;
+
+	std::vector<Room::ID> nearby;
+	for (auto &door : pendingRoom.doors)
+		nearby.push_back(door.target);
+
+	// Demoted first, so that the bodies they free are available to the promoted room
+	for (auto &room : rooms) {
+		if (room.first == pendingRoom.id)
+			continue;
+
+		const bool isNearby = std::find(nearby.begin(), nearby.end(), room.first) != nearby.end();
+		setLod(room.second, isNearby ? Nearby : Dormant);
+	}
+
+	for (auto &room : pendingAdjacent)
+		if (!rooms.count(room.id))
+			populate(room, rooms[room.id]);
+
+	if (!rooms.count(pendingRoom.id))
+		populate(pendingRoom, rooms[pendingRoom.id]);
+	setLod(rooms[pendingRoom.id], Active);
+
+	for (auto &room : pendingAdjacent)
+		setLod(rooms[room.id], Nearby);
+
+	unsigned int active = 0, asleep = 0, stored = 0;
+	for (auto &room : rooms) {
+		if (room.second.lod == Active)
+			active += (unsigned int)room.second.live.size();
+		else if (room.second.lod == Nearby)
+			asleep += (unsigned int)room.second.live.size();
+
+		stored += (unsigned int)room.second.stored.size();
+	}
+
+	roomsCount = (unsigned int)rooms.size();
+	activeCount = active;
+	nearbyCount = asleep;
+	storedCount = stored;
+}
+
+void WorldManager::setLod(RoomState& state, Lod lod) {
+	if (state.lod == lod)
+		return;
+
+	// The enemies killed since the last change are gone
+	state.live.erase(std::remove_if(state.live.begin(), state.live.end(), [this](const Spawner::EnemyHandle& handle) {
+		return spawner.getEntity(handle) == ECS::NullEntity;
+	}), state.live.end());
+
+	if (lod == Dormant) {
+		store(state);
+	} else {
+		if (state.lod == Dormant)
+			restore(state, lod);
+
+		for (auto &handle : state.live) {
+			if (lod == Active)
+				wake(spawner.getEntity(handle));
+			else
+				sleep(spawner.getEntity(handle));
+		}
+	}
+
+	state.lod = lod;
+}
+
+void WorldManager::populate(const RoomData& room, RoomState& state) {
+	state.lod = Dormant;
+	state.stored.reserve(room.enemies.size());
+
+	// Placed as stored enemies, the LOD of the room decides if they are spawned
+	for (auto &enemy : room.enemies) {
+		StoredEnemy stored;
+		stored.transform = ECS::Transform{ enemy.position, Vector2f() };
+		stored.vitals = ECS::Vitals{ 3, 100 };
+		stored.ai = ECS::AI{ enemy.behaviour, enemy.speed, enemy.range, enemy.position };
+		stored.hasBody = true;
+
+		state.stored.push_back(stored);
+	}
+}
+
+void WorldManager::store(RoomState& state) {
+	state.stored.reserve(state.stored.size() + state.live.size());
+
+	for (auto &handle : state.live) {
+		const ECS::Entity entity = spawner.getEntity(handle);
+
+		StoredEnemy stored;
+		stored.transform = registry.get<ECS::Transform>(entity);
+		stored.vitals = registry.get<ECS::Vitals>(entity);
+		stored.ai = registry.get<ECS::AI>(entity);
+		stored.hasBody = registry.has<ECS::PhysicsHandle>(entity) || (registry.has<ECS::Asleep>(entity) && registry.get<ECS::Asleep>(entity).hadBody);
+
+		state.stored.push_back(stored);
+		spawner.despawn(handle);
+	}
+
+	state.live.clear();
+}
+
+void WorldManager::restore(RoomState& state, Lod lod) {
+	for (auto &stored : state.stored) {
+		const Spawner::EnemyHandle handle = spawner.spawnEnemy(stored.transform.position, stored.ai.behaviour, stored.ai.speed, stored.ai.range);
+		if (handle.isNull()) {
+			std::cerr << "[Warning] WorldManager::restore - the enemies pool is full, an enemy is lost" << std::endl;
+			continue;
+		}
+
+		const ECS::Entity entity = spawner.getEntity(handle);
+		registry.get<ECS::Transform>(entity) = stored.transform;
+		registry.get<ECS::Vitals>(entity) = stored.vitals;
+		registry.get<ECS::AI>(entity) = stored.ai;
+
+		// Spawned with a body, which only an active enemy keeps
+		if (!stored.hasBody)
+			registry.remove<ECS::PhysicsHandle>(entity);
+		else if (lod == Nearby)
+			sleep(entity);
+		else if (registry.has<ECS::PhysicsHandle>(entity))
+			registry.get<ECS::PhysicsHandle>(entity).body->velocity = stored.transform.velocity;
+
+		state.live.push_back(handle);
+	}
+
+	state.stored.clear();
+}
+
+void WorldManager::sleep(ECS::Entity entity) {
+	if (registry.has<ECS::Asleep>(entity))
+		return;
+
+	// Removing the handle destroys the body (see ECS::connectHooks)
+	const bool hadBody = registry.has<ECS::PhysicsHandle>(entity);
+	registry.remove<ECS::PhysicsHandle>(entity);
+	registry.assign<ECS::Asleep>(entity, hadBody);
+}
+
+void WorldManager::wake(ECS::Entity entity) {
+	if (!registry.has<ECS::Asleep>(entity))
+		return;
+
+	const bool hadBody = registry.get<ECS::Asleep>(entity).hadBody;
+	registry.remove<ECS::Asleep>(entity);
+
+	if (hadBody)
+		spawner.attachEnemyBody(entity);
+}
+
+WorldManager::Lod WorldManager::getLod(Room::ID room) const {
+	auto found = rooms.find(room);
+	return found != rooms.end() ? found->second.lod : Dormant;
+}
+
+WorldManager::Stats WorldManager::getStats() const {
+	Stats stats;
+	stats.rooms = roomsCount;
+	stats.active = activeCount;
+	stats.nearby = nearbyCount;
+	stats.stored = storedCount;
+
+	return stats;
+}
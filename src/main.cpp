@@ -15,24 +15,47 @@
 #include <SDL2/SDL_image.h>
 
 #include "Game.hpp"
+#include "GameOptions.hpp"
+#include "Utils/StartupTimeline.hpp"
 
-int main(int, char**) {
+int main(int argc, char** argv) {
 	srand((unsigned int)time(NULL));
 
-	SDL_Init(SDL_INIT_EVERYTHING);
-	IMG_Init(IMG_INIT_PNG);
+	GameOptions options;
+	try {
+		options = GameOptions::parse(argc, argv);
+	} catch(std::exception &e) {
+		std::cerr << "\n EXCEPTION: " << e.what() << std::endl;
+		return 1;
+	}
+
+	// Only the subsystems the game uses, each costs at startup (SDL_INIT_EVERYTHING opens the audio, joystick and haptic devices).
+	// Headless runs never open a window, the video subsystem is not needed. A later user of another subsystem calls SDL_InitSubSystem.
+	{
+		StartupTimeline::Stage stage("SDL_Init");
+		SDL_Init(options.headless ? SDL_INIT_TIMER | SDL_INIT_EVENTS : SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_EVENTS);
+	}
+
+	// Before the Game starts the prefetcher : SDL_image initializes its decoders without synchronization,
+	// the first decode must not be raced by the prefetcher and the main thread
+	{
+		StartupTimeline::Stage stage("IMG_Init");
+		IMG_Init(IMG_INIT_PNG);
+	}
 
+	int status = 0;
 	try {
-		Game game;
-		game.run();
+		Game game(options);
+		status = game.run();
 	} catch(std::exception &e) {
 		std::cerr << "\n EXCEPTION: " << e.what() << std::endl;
+		status = 1;
 	}
 
 	IMG_Quit();
 	SDL_Quit();
 
-	return 0;
+	return status;
 }
 
 
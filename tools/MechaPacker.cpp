@@ -0,0 +1,65 @@
+/**
+ * Builds the assets pack read by ResourcesLoader.
+ * Usage : mecha_pack <output.mvpk> [assets directory]
+ *
+ * Every Image::ID is decoded once here and stored as RGBA32 pixels, so that the game only has to map the pack and upload.
+ */
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include "ResourcesID.hpp"
+#include "ResourcesPack.hpp"
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <output.mvpk> [assets directory]" << std::endl;
+		return 1;
+	}
+
+	const std::string output(argv[1]);
+	const std::string directory(argc > 2 ? std::string(argv[2]) + "/" : "");
+
+	IMG_Init(IMG_INIT_PNG);
+
+	int res = 0;
+	try {
+		ResourcesPackWriter writer;
+
+		for (int i = 0; i < Image::Count; ++i) {
+			const Image::ID id = (Image::ID)i;
+			const std::string filename(directory + Image::fileName(id));
+
+			SDL_Surface *image = IMG_Load(filename.c_str());
+			if (!image)
+				throw std::runtime_error("failed to load " + filename + ": " + IMG_GetError());
+
+			SDL_Surface *converted = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0);
+			SDL_FreeSurface(image);
+			if (!converted)
+				throw std::runtime_error("failed to convert " + filename + ": " + SDL_GetError());
+
+			SDL_LockSurface(converted);
+			writer.add(id, SDL_PIXELFORMAT_RGBA32, converted->w, converted->h, converted->pitch, converted->pixels);
+			SDL_UnlockSurface(converted);
+			SDL_FreeSurface(converted);
+
+			std::cout << "Packed " << filename << std::endl;
+		}
+
+		writer.write(output);
+	} catch(std::exception &e) {
+		std::cerr << "[Error] mecha_pack - " << e.what() << std::endl;
+		res = 1;
+	}
+
+	IMG_Quit();
+
+	return res;
+}
@@ -0,0 +1,290 @@
+/**
+ * Replays a render capture written by the game (--capture) against SDL's software renderer.
+ * Usage : mecha_replay <capture> [--pack=<file>] [--repeat=<count>] [--commands=<file.csv>]
+ *
+ * Prints for each frame the cost of its copies, the texture switches against the fewest the frame could do (one per image),
+ * and the overdraw : pixels drawn per pixel covered. --commands writes the cost of every copy, the smallest of <count> replays (3 by default).
+ * The textures come from the pack when given, from generated images as large as the copies need otherwise : only their size matters to the cost.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include "RenderCapture.hpp"
+#include "ResourcesPack.hpp"
+
+namespace {
+	typedef std::chrono::steady_clock Clock;
+
+	struct ImageCost {
+		unsigned long long copies;
+		unsigned long long pixels;
+		double ns;
+	};
+
+	struct Totals {
+		unsigned long long frames;
+		unsigned long long copies;
+		unsigned long long switches;
+		unsigned long long minSwitches;
+		unsigned long long drawnPixels;
+		unsigned long long coveredPixels;
+		double ns;
+	};
+
+	// One texture per image of the capture : from the pack, or generated and large enough for every source rectangle
+	class Textures {
+		public:
+			Textures(SDL_Renderer *renderer, const std::string& packFile, const std::string& captureFile) :
+				renderer(renderer)
+			{
+				if (!packFile.empty() && !pack.open(packFile))
+					throw std::runtime_error("[Error] mecha_replay - failed to open " + packFile);
+
+				// The extents need a first pass over the capture
+				std::map<uint32_t, SDL_Point> extents;
+				RenderCaptureReader reader(captureFile);
+				RenderCaptureReader::Frame frame;
+				while (reader.next(frame)) {
+					for (auto &command : frame.commands) {
+						SDL_Point &extent = extents[command.image];
+						extent.x = std::max(extent.x, command.src.x + command.src.w);
+						extent.y = std::max(extent.y, command.src.y + command.src.h);
+					}
+				}
+
+				for (auto &kv : extents)
+					textures[kv.first] = create((Image::ID)kv.first, kv.second);
+			}
+
+			~Textures() {
+				for (auto &kv : textures)
+					SDL_DestroyTexture(kv.second);
+			}
+
+			SDL_Texture* get(uint32_t image) const { return textures.at(image); }
+
+		private:
+			SDL_Texture* create(Image::ID id, const SDL_Point& extent) {
+				ResourcesPack::Entry entry;
+				std::vector<uint32_t> generated;
+
+				if (!pack.isOpen() || !pack.find(id, entry)) {
+					// Half transparent checker, blended as the images with an alpha channel are
+					entry.format = SDL_PIXELFORMAT_RGBA32;
+					entry.width = std::max(extent.x, 1);
+					entry.height = std::max(extent.y, 1);
+					entry.pitch = entry.width * 4;
+
+					generated.resize((size_t)entry.width * (size_t)entry.height);
+					for (int y = 0; y < entry.height; y++)
+						for (int x = 0; x < entry.width; x++)
+							generated[(size_t)(y * entry.width + x)] = (x / 8 + y / 8) % 2 ? 0xFFC08040u : 0x80406080u;
+					entry.pixels = generated.data();
+				}
+
+				SDL_Texture *texture = SDL_CreateTexture(renderer, entry.format, SDL_TEXTUREACCESS_STATIC, entry.width, entry.height);
+				if (!texture || SDL_UpdateTexture(texture, nullptr, entry.pixels, entry.pitch) != 0)
+					throw std::runtime_error("[Error] mecha_replay - failed to create the texture of image " + std::to_string(id) + ": " + SDL_GetError());
+				SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+				return texture;
+			}
+
+		private:
+			SDL_Renderer *renderer;
+			ResourcesPack pack;
+			std::map<uint32_t, SDL_Texture*> textures;
+	};
+
+	// Pixels of the copy on screen
+	unsigned long long clippedArea(const SDL_Rect& dst, int width, int height) {
+		const int x0 = std::max(dst.x, 0), y0 = std::max(dst.y, 0);
+		const int x1 = std::min(dst.x + dst.w, width), y1 = std::min(dst.y + dst.h, height);
+		return (x1 > x0 && y1 > y0) ? (unsigned long long)(x1 - x0) * (unsigned long long)(y1 - y0) : 0;
+	}
+
+	// Marks the pixels covered by the copies, returns how many are covered at least once
+	unsigned long long coveredArea(const std::vector<Capture::Command>& commands, int width, int height, std::vector<unsigned char>& covered) {
+		covered.assign((size_t)width * (size_t)height, 0);
+
+		unsigned long long count = 0;
+		for (auto &command : commands) {
+			const SDL_Rect &dst = command.dst;
+			const int x0 = std::max(dst.x, 0), y0 = std::max(dst.y, 0);
+			const int x1 = std::min(dst.x + dst.w, width), y1 = std::min(dst.y + dst.h, height);
+
+			for (int y = y0; y < y1; y++) {
+				unsigned char *row = &covered[(size_t)y * (size_t)width];
+				for (int x = x0; x < x1; x++) {
+					count += !row[x];
+					row[x] = 1;
+				}
+			}
+		}
+
+		return count;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <capture> [--pack=<file>] [--repeat=<count>] [--commands=<file.csv>]" << std::endl;
+		return 1;
+	}
+
+	const std::string captureFile(argv[1]);
+	std::string packFile, commandsFile;
+	unsigned int repeat = 3;
+
+	for (int i = 2; i < argc; i++) {
+		const std::string arg(argv[i]);
+
+		if (arg.compare(0, 7, "--pack=") == 0) {
+			packFile = arg.substr(7);
+		} else if (arg.compare(0, 11, "--commands=") == 0) {
+			commandsFile = arg.substr(11);
+		} else if (arg.compare(0, 9, "--repeat=") == 0) {
+			std::istringstream in(arg.substr(9));
+			if (!(in >> repeat) || repeat == 0) {
+				std::cerr << "[Error] mecha_replay - expected a count in " << arg << std::endl;
+				return 1;
+			}
+		} else {
+			std::cerr << "[Error] mecha_replay - unknown argument " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	SDL_SetMainReady();
+
+	int res = 0;
+	SDL_Surface *target = nullptr;
+	SDL_Renderer *renderer = nullptr;
+	try {
+		RenderCaptureReader reader(captureFile);
+		const int width = reader.getScreenWidth(), height = reader.getScreenHeight();
+
+		target = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
+		renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+		if (!renderer)
+			throw std::runtime_error(std::string("[Error] mecha_replay - failed to create the software renderer: ") + SDL_GetError());
+
+		Textures textures(renderer, packFile, captureFile);
+
+		std::ofstream commandsOut;
+		if (!commandsFile.empty()) {
+			commandsOut.open(commandsFile);
+			if (!commandsOut)
+				throw std::runtime_error("[Error] mecha_replay - failed to write " + commandsFile);
+			commandsOut << "frame,index,image,src_x,src_y,src_w,src_h,dst_x,dst_y,dst_w,dst_h,pixels,ns\n";
+		}
+
+		std::cout << std::right << std::setw(8) << "frame" << std::setw(9) << "copies" << std::setw(8) << "culled" << std::setw(10) << "ms"
+			<< std::setw(10) << "switches" << std::setw(8) << "min" << std::setw(11) << "overdraw" << std::setw(10) << "covered" << std::endl;
+		std::cout << std::fixed;
+
+		Totals totals = {};
+		std::map<uint32_t, ImageCost> images;
+		std::vector<double> costs;
+		std::vector<unsigned char> covered;
+
+		RenderCaptureReader::Frame frame;
+		while (reader.next(frame)) {
+			const std::vector<Capture::Command> &commands = frame.commands;
+
+			// Smallest cost of each copy over the replays, the first replay also warms the caches
+			costs.assign(commands.size(), 1e300);
+			for (unsigned int r = 0; r < repeat; r++) {
+				SDL_RenderClear(renderer);
+				for (size_t i = 0; i < commands.size(); i++) {
+					SDL_Texture *texture = textures.get(commands[i].image);
+					const Clock::time_point start = Clock::now();
+					SDL_RenderCopy(renderer, texture, &commands[i].src, &commands[i].dst);
+					const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+					costs[i] = std::min(costs[i], ns);
+				}
+				SDL_RenderPresent(renderer);
+			}
+
+			double frameNs = 0.;
+			unsigned long long switches = 0, drawn = 0;
+			std::set<uint32_t> used;
+			for (size_t i = 0; i < commands.size(); i++) {
+				const Capture::Command &command = commands[i];
+				const unsigned long long pixels = clippedArea(command.dst, width, height);
+
+				if (!i || command.image != commands[i - 1].image)
+					switches++;
+				used.insert(command.image);
+				drawn += pixels;
+				frameNs += costs[i];
+
+				ImageCost &image = images[command.image];
+				image.copies++;
+				image.pixels += pixels;
+				image.ns += costs[i];
+
+				if (commandsOut.is_open())
+					commandsOut << frame.frame << ',' << i << ',' << command.image << ',' << command.src.x << ',' << command.src.y << ',' << command.src.w << ','
+						<< command.src.h << ',' << command.dst.x << ',' << command.dst.y << ',' << command.dst.w << ',' << command.dst.h << ','
+						<< pixels << ',' << costs[i] << '\n';
+			}
+
+			const unsigned long long coveredPixels = coveredArea(commands, width, height, covered);
+			std::cout << std::setw(8) << frame.frame << std::setw(9) << commands.size() << std::setw(8) << frame.culledCount
+				<< std::setw(10) << std::setprecision(3) << frameNs / 1e6 << std::setw(10) << switches << std::setw(8) << used.size()
+				<< std::setw(11) << std::setprecision(2) << (coveredPixels ? (double)drawn / (double)coveredPixels : 0.)
+				<< std::setw(9) << std::setprecision(1) << 100. * (double)coveredPixels / ((double)width * (double)height) << '%' << std::endl;
+
+			totals.frames++;
+			totals.copies += commands.size();
+			totals.switches += switches;
+			totals.minSwitches += used.size();
+			totals.drawnPixels += drawn;
+			totals.coveredPixels += coveredPixels;
+			totals.ns += frameNs;
+		}
+
+		if (!totals.frames)
+			throw std::runtime_error("[Error] mecha_replay - " + captureFile + " holds no frame");
+
+		const double frames = (double)totals.frames;
+		std::cout << std::endl << totals.frames << " frames, per frame : " << std::setprecision(1) << (double)totals.copies / frames << " copies in "
+			<< std::setprecision(3) << totals.ns / frames / 1e6 << " ms, " << std::setprecision(1) << (double)totals.switches / frames
+			<< " texture switches (" << (double)totals.minSwitches / frames << " at best), overdraw " << std::setprecision(2)
+			<< (totals.coveredPixels ? (double)totals.drawnPixels / (double)totals.coveredPixels : 0.) << std::endl;
+
+		std::cout << std::endl << std::setw(8) << "image" << std::setw(12) << "copies" << std::setw(14) << "pixels" << std::setw(10) << "ms"
+			<< std::setw(12) << "ns/copy" << std::setw(12) << "ns/kpixel" << std::endl;
+		for (auto &kv : images) {
+			const ImageCost &image = kv.second;
+			std::cout << std::setw(8) << kv.first << std::setw(12) << image.copies << std::setw(14) << image.pixels << std::setw(10) << std::setprecision(3)
+				<< image.ns / 1e6 << std::setw(12) << std::setprecision(1) << image.ns / (double)image.copies
+				<< std::setw(12) << (image.pixels ? image.ns * 1000. / (double)image.pixels : 0.) << std::endl;
+		}
+	} catch(std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		res = 1;
+	}
+
+	if (renderer)
+		SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+	SDL_Quit();
+
+	return res;
+}